@@ -18,6 +18,7 @@
 #include "los.h"
 #include "mon-behv.h"
 #include "mon-death.h"
+#include "nearby-danger.h"
 #include "religion.h"
 #include "stepdown.h"
 #include "stringutil.h"
@@ -139,6 +140,7 @@ void actor::set_position(const coord_def &c)
     position = c;
     los_actor_moved(this, oldpos);
     areas_actor_moved(this, oldpos);
+    invalidate_threat_set();
 }
 
 bool actor::can_hibernate(bool holi_only, bool intrinsic_only) const
@@ -100,6 +100,7 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
     $(CRAWL_PATH)/god-passive.cc \
     $(CRAWL_PATH)/god-prayer.cc \
     $(CRAWL_PATH)/god-wrath.cc \
+    $(CRAWL_PATH)/grid-changes.cc \
     $(CRAWL_PATH)/hash.cc \
     $(CRAWL_PATH)/hints.cc \
     $(CRAWL_PATH)/hiscores.cc \
@@ -142,6 +143,8 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
     $(CRAWL_PATH)/l-you.cc \
     $(CRAWL_PATH)/lang-fake.cc \
     $(CRAWL_PATH)/lev-pand.cc \
+    $(CRAWL_PATH)/level-catchup.cc \
+    $(CRAWL_PATH)/level-prefetch.cc \
     $(CRAWL_PATH)/libutil.cc \
     $(CRAWL_PATH)/lookup-help.cc \
     $(CRAWL_PATH)/los.cc \
@@ -214,6 +217,7 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
     $(CRAWL_PATH)/random-var.cc \
     $(CRAWL_PATH)/ranged-attack.cc \
     $(CRAWL_PATH)/ray.cc \
+    $(CRAWL_PATH)/replay.cc \
     $(CRAWL_PATH)/rot.cc \
     $(CRAWL_PATH)/religion.cc \
     $(CRAWL_PATH)/shopping.cc \
@@ -260,6 +264,7 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
     $(CRAWL_PATH)/transform.cc \
     $(CRAWL_PATH)/traps.cc \
     $(CRAWL_PATH)/travel.cc \
+    $(CRAWL_PATH)/turn-profile.cc \
     $(CRAWL_PATH)/tutorial.cc \
     $(CRAWL_PATH)/uncancel.cc \
     $(CRAWL_PATH)/unicode.cc \
@@ -275,6 +280,7 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
     $(CRAWL_PATH)/wiz-mon.cc \
     $(CRAWL_PATH)/wiz-you.cc \
     $(CRAWL_PATH)/wizard.cc \
+    $(CRAWL_PATH)/worker-pool.cc \
     $(CRAWL_PATH)/worley.cc \
     $(CRAWL_PATH)/xom.cc \
     $(CRAWL_PATH)/tilepick.cc \
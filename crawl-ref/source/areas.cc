@@ -194,6 +194,17 @@ static void _update_agrid()
     _agrid_valid = true;
 }
 
+/**
+ * Might any cell of the level be in an area (halo, silence, umbra and so
+ * on)? Sanctuary is not counted; it is kept in env.pgrid.
+ */
+bool areas_present()
+{
+    if (!_agrid_valid)
+        _update_agrid();
+    return !no_areas;
+}
+
 static area_centre_type _get_first_area(const coord_def& f)
 {
     areaprops a = _agrid(f);
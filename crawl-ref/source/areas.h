@@ -17,6 +17,7 @@ enum area_centre_type
 };
 
 void invalidate_agrid(bool recheck_new = false);
+bool areas_present();
 
 class actor;
 void areas_actor_moved(const actor* act, const coord_def& oldpos);
@@ -7,6 +7,7 @@
 
 #include "arena.h"
 
+#include <chrono>
 #include <stdexcept>
 
 #include "act-iter.h"
@@ -19,6 +20,8 @@
 #include "item-name.h"
 #include "item-status-flag-type.h"
 #include "items.h"
+#include "json.h"
+#include "json-wrapper.h"
 #include "libutil.h"
 #include "los.h"
 #include "macro.h"
@@ -32,8 +35,10 @@
 #include "newgame-def.h"
 #include "ng-init.h"
 #include "spl-miscast.h"
+#include "spl-util.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "teleport.h"
 #include "terrain.h"
 #ifdef USE_TILE
@@ -43,6 +48,7 @@
 #include "version.h"
 #include "view.h"
 #include "ui.h"
+#include "worker-pool.h"
 
 using namespace ui;
 
@@ -159,6 +165,7 @@ static void _results_popup(string msg, bool error=false)
 namespace arena
 {
     static bool skipped_arena_ui = true; // whether this is an interactive session
+    static bool batch_mode = false;      // headless -arena-batch run
     static void write_error(const string &error);
 
     struct arena_error : public runtime_error
@@ -219,6 +226,11 @@ namespace arena
     static int ties        = 0;
 
     static int turns       = 0;
+    static int max_turns   = 0; // 0 for no limit
+    static bool timed_out  = false;
+
+    // Spells cast during the current round by faction a and faction b.
+    static map<spell_type, int> spell_casts[2];
 
     static bool allow_summons       = true;
     static bool allow_animate       = true;
@@ -446,6 +458,7 @@ namespace arena
         respawn         =  strip_tag(spec, "respawn");
         move_respawns   =  strip_tag(spec, "move_respawns");
         summon_throttle = strip_number_tag(spec, "summon_throttle:");
+        max_turns       = strip_number_tag(spec, "max_turns:");
 
         if (real_summons && respawn)
         {
@@ -456,6 +469,11 @@ namespace arena
         if (summon_throttle <= 0)
             summon_throttle = INT_MAX;
 
+        // A batch run can't be cancelled by hand, so make sure that two
+        // sides which can't reach each other still finish eventually.
+        if (max_turns <= 0)
+            max_turns = batch_mode ? 10000 : 0;
+
         cycle_random   = strip_tag(spec, "cycle_random");
         name_monsters  = strip_tag(spec, "names");
         random_uniques = strip_tag(spec, "random_uniques");
@@ -559,6 +577,9 @@ namespace arena
 
     static void show_fight_banner(bool after_fight = false)
     {
+        if (batch_mode)
+            return;
+
         int line = 1;
 
         cgotoxy(1, line++, GOTO_STAT);
@@ -851,15 +872,25 @@ namespace arena
 
     static void do_fight()
     {
-        viewwindow();
-        clear_messages(true);
+        if (!batch_mode)
+        {
+            viewwindow();
+            clear_messages(true);
+        }
 
+        timed_out = false;
         {
             cursor_control coff(false);
             while (fight_is_on() && !contest_cancelled)
             {
+                if (max_turns > 0 && turns >= max_turns)
+                {
+                    timed_out = true;
+                    break;
+                }
 #ifdef ARENA_VERBOSE
-                mprf("---- Turn #%d ----", turns);
+                if (!batch_mode)
+                    mprf("---- Turn #%d ----", turns);
 #endif
 
                 // Check the consistency of our book-keeping every 100 turns.
@@ -875,11 +906,15 @@ namespace arena
                 do_respawn(faction_a);
                 do_respawn(faction_b);
                 balance_spawners();
-                ui_delay(Options.view_delay);
-                clear_messages();
+                if (!batch_mode)
+                {
+                    ui_delay(Options.view_delay);
+                    clear_messages();
+                }
                 ASSERT(you.pet_target == MHITNOT);
             }
-            viewwindow();
+            if (!batch_mode)
+                viewwindow();
         }
 
         if (contest_cancelled)
@@ -894,6 +929,16 @@ namespace arena
 
         trials_done++;
 
+        if (timed_out)
+        {
+            faction_a.won = false;
+            faction_b.won = false;
+            ties++;
+            show_fight_banner(true);
+            mprf("Tie: the turn limit of %d was reached.", max_turns);
+            return;
+        }
+
         // We bother with all this to properly deal with ties, and with
         // ball lightning or ballistomycete spores winning the fight via suicide.
         // The sanity checking is probably just paranoia.
@@ -983,8 +1028,11 @@ namespace arena
         // Set various options from the arena spec's tags
         parse_monster_spec(); // may throw an arena_error
 
-        crawl_view.init_geometry();
-        expand_mlist(5);
+        if (!batch_mode)
+        {
+            crawl_view.init_geometry();
+            expand_mlist(5);
+        }
 
         for (monster_type i = MONS_0; i < NUM_MONSTERS; ++i)
         {
@@ -1095,6 +1143,231 @@ namespace arena
 
         write_results();
     }
+
+    // The outcome of one round of a batch run, passed back from the worker
+    // process that ran it.
+    struct round_result
+    {
+        int winner;     // 0 for faction a, 1 for faction b, -1 for a tie
+        bool timed_out;
+        int turns;
+        map<spell_type, int> casts[2];
+
+        round_result() : winner(-1), timed_out(false), turns(0) { }
+
+        string serialise() const
+        {
+            string data = make_stringf("%d %d %d\n", winner, timed_out,
+                                       turns);
+            for (int side = 0; side < 2; ++side)
+                for (const auto &cast : casts[side])
+                {
+                    data += make_stringf("%d %d %d\n", side, cast.first,
+                                         cast.second);
+                }
+            return data;
+        }
+
+        bool deserialise(const string &data)
+        {
+            const vector<string> lines = split_string("\n", data);
+            int timeout;
+            if (lines.empty()
+                || sscanf(lines[0].c_str(), "%d %d %d",
+                          &winner, &timeout, &turns) != 3)
+            {
+                return false;
+            }
+            timed_out = timeout;
+            for (unsigned int i = 1; i < lines.size(); ++i)
+            {
+                int side, spell, count;
+                if (sscanf(lines[i].c_str(), "%d %d %d",
+                           &side, &spell, &count) != 3
+                    || side < 0 || side > 1 || !is_valid_spell((spell_type)spell))
+                {
+                    return false;
+                }
+                casts[side][static_cast<spell_type>(spell)] = count;
+            }
+            return true;
+        }
+    };
+
+    static uint64_t batch_seed = 0;
+
+    /// Run round number `round` of a batch run; called in a worker process.
+    static string batch_round(int round)
+    {
+        // Seed from the round number so that results don't depend on how
+        // the rounds were dealt out to workers. The parity of trials_done
+        // decides which faction is placed first.
+        seed_rng(batch_seed + round);
+        trials_done = round;
+        contest_cancelled = false;
+        spell_casts[0].clear();
+        spell_casts[1].clear();
+
+        try
+        {
+            setup_fight();
+        }
+        catch (const arena_error &error)
+        {
+            fprintf(stderr, "Arena round %d: %s\n", round, error.what());
+            return "";
+        }
+        do_fight();
+
+        round_result result;
+        result.winner = faction_a.won ? 0 : faction_b.won ? 1 : -1;
+        result.timed_out = timed_out;
+        result.turns = turns;
+        result.casts[0] = spell_casts[0];
+        result.casts[1] = spell_casts[1];
+        return result.serialise();
+    }
+
+    static void write_batch_report(const vector<round_result> &results,
+                                   int failed, double seconds)
+    {
+        int wins[2] = { 0, 0 };
+        int total_ties = 0, timeouts = 0;
+        int min_turns = INT_MAX, max_turns_seen = 0;
+        int64_t total_turns = 0;
+        map<spell_type, int> casts[2];
+
+        for (const round_result &res : results)
+        {
+            if (res.winner >= 0)
+                wins[res.winner]++;
+            else
+                total_ties++;
+            if (res.timed_out)
+                timeouts++;
+            total_turns += res.turns;
+            min_turns = min(min_turns, res.turns);
+            max_turns_seen = max(max_turns_seen, res.turns);
+            for (int side = 0; side < 2; ++side)
+                for (const auto &cast : res.casts[side])
+                    casts[side][cast.first] += cast.second;
+        }
+
+        const int rounds = results.size();
+        if (!rounds)
+            min_turns = 0;
+        const double mean_turns = rounds ? (double)total_turns / rounds : 0;
+        const faction *factions[2] = { &faction_a, &faction_b };
+
+        const string filename = SysEnv.report_file.empty()
+                                ? "arena-batch.json" : SysEnv.report_file;
+        FILE *report = fopen_u(filename.c_str(), "w");
+        if (!report)
+        {
+            end(1, true, "Can't write arena report to %s",
+                filename.c_str());
+        }
+
+        if (ends_with(lowercase_string(filename), ".csv"))
+        {
+            fprintf(report, "section,faction,name,value\n");
+            fprintf(report, "summary,,rounds,%d\n", rounds);
+            fprintf(report, "summary,,failed,%d\n", failed);
+            fprintf(report, "summary,,ties,%d\n", total_ties);
+            fprintf(report, "summary,,timeouts,%d\n", timeouts);
+            fprintf(report, "summary,,seed,%" PRIu64 "\n", batch_seed);
+            fprintf(report, "summary,,seconds,%.3f\n", seconds);
+            fprintf(report, "turns,,mean,%.2f\n", mean_turns);
+            fprintf(report, "turns,,min,%d\n", min_turns);
+            fprintf(report, "turns,,max,%d\n", max_turns_seen);
+            for (int side = 0; side < 2; ++side)
+            {
+                const string desc = replace_all(factions[side]->desc,
+                                                "\"", "\"\"");
+                fprintf(report, "wins,\"%s\",wins,%d\n", desc.c_str(),
+                        wins[side]);
+                fprintf(report, "wins,\"%s\",win_rate,%.4f\n", desc.c_str(),
+                        rounds ? (double)wins[side] / rounds : 0.0);
+                for (const auto &cast : casts[side])
+                {
+                    fprintf(report, "spells,\"%s\",%s,%d\n", desc.c_str(),
+                            spell_title(cast.first), cast.second);
+                }
+            }
+        }
+        else
+        {
+            JsonWrapper json(json_mkobject());
+            json_append_member(json.node, "teams",
+                               json_mkstring(teams.c_str()));
+            json_append_member(json.node, "seed",
+                               json_mkstring(to_string(batch_seed).c_str()));
+            json_append_member(json.node, "rounds", json_mknumber(rounds));
+            json_append_member(json.node, "failed", json_mknumber(failed));
+            json_append_member(json.node, "ties", json_mknumber(total_ties));
+            json_append_member(json.node, "timeouts",
+                               json_mknumber(timeouts));
+            json_append_member(json.node, "seconds", json_mknumber(seconds));
+
+            JsonNode *turn_stats = json_mkobject();
+            json_append_member(turn_stats, "mean", json_mknumber(mean_turns));
+            json_append_member(turn_stats, "min", json_mknumber(min_turns));
+            json_append_member(turn_stats, "max",
+                               json_mknumber(max_turns_seen));
+            json_append_member(json.node, "turns", turn_stats);
+
+            JsonNode *sides = json_mkarray();
+            for (int side = 0; side < 2; ++side)
+            {
+                JsonNode *fac = json_mkobject();
+                json_append_member(fac, "name",
+                    json_mkstring(factions[side]->desc.c_str()));
+                json_append_member(fac, "wins", json_mknumber(wins[side]));
+                json_append_member(fac, "win_rate",
+                    json_mknumber(rounds ? (double)wins[side] / rounds : 0));
+                JsonNode *spells = json_mkobject();
+                for (const auto &cast : casts[side])
+                {
+                    json_append_member(spells, spell_title(cast.first),
+                                       json_mknumber(cast.second));
+                }
+                json_append_member(fac, "spells", spells);
+                json_append_element(sides, fac);
+            }
+            json_append_member(json.node, "factions", sides);
+
+            fprintf(report, "%s\n", json.to_string().c_str());
+        }
+        fclose(report);
+
+        printf("%s: %d; %s: %d; ties: %d (%d timed out); failed: %d\n"
+               "Mean length %.1f turns; %d rounds in %.1fs. Report: %s\n",
+               faction_a.desc.c_str(), wins[0],
+               faction_b.desc.c_str(), wins[1], total_ties, timeouts, failed,
+               mean_turns, rounds, seconds, filename.c_str());
+    }
+
+    static void simulate_batch(int rounds)
+    {
+        init_level_connectivity();
+
+        const auto start = chrono::steady_clock::now();
+        const vector<string> data = run_worker_jobs(rounds, batch_round);
+        const chrono::duration<double> elapsed =
+            chrono::steady_clock::now() - start;
+
+        vector<round_result> results;
+        int failed = 0;
+        for (const string &round : data)
+        {
+            round_result res;
+            if (res.deserialise(round))
+                results.push_back(res);
+            else
+                failed++;
+        }
+        write_batch_report(results, failed, elapsed.count());
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1242,6 +1515,14 @@ void arena_placed_monster(monster* mons)
     }
 }
 
+void arena_monster_cast(const monster* mons, spell_type spell)
+{
+    if (mons->attitude == ATT_FRIENDLY)
+        arena::spell_casts[0][spell]++;
+    else if (mons->attitude == ATT_HOSTILE)
+        arena::spell_casts[1][spell]++;
+}
+
 // Take care of respawning slime creatures merging and then splitting.
 void arena_split_monster(monster* split_from, monster* split_to)
 {
@@ -1586,3 +1867,37 @@ NORETURN void run_arena(const newgame_def& choice, const string &default_arena_t
     }
     while (true);
 }
+
+/**
+ * Run the fight given by -arena (or a random one) -arena-batch times without
+ * any display, spread over -workers processes, and write the aggregated
+ * results to -report.
+ */
+NORETURN void run_arena_batch(const string &teams)
+{
+    crawl_state.type = GAME_TYPE_ARENA;
+    crawl_state.last_type = GAME_TYPE_ARENA;
+    _init_arena();
+
+#ifdef WIZARD
+    you.wizard = true;
+#endif
+
+    arena::batch_mode = true;
+    no_messages mx;
+
+    try
+    {
+        arena::global_setup(teams);
+    }
+    catch (const arena::arena_error &error)
+    {
+        end(1, false, "Arena error: %s\n", error.what());
+    }
+
+    reset_rng();
+    arena::batch_seed = crawl_state.seed;
+    arena::simulate_batch(SysEnv.arena_batch_rounds);
+    arena::global_shutdown();
+    end(0);
+}
@@ -16,6 +16,7 @@ struct coord_def;
 struct newgame_def;
 
 NORETURN void run_arena(const newgame_def& choice, const string &default_arena_teams);
+NORETURN void run_arena_batch(const string &teams);
 
 monster_type arena_pick_random_monster(const level_id &place);
 
@@ -26,6 +27,8 @@ bool arena_veto_place_monster(const mgen_data &mg, bool first_band_member,
 
 void arena_placed_monster(monster* mons);
 
+void arena_monster_cast(const monster* mons, spell_type spell);
+
 void arena_split_monster(monster* split_from, monster* split_to);
 
 void arena_monster_died(monster* mons, killer_type killer,
@@ -1032,6 +1032,8 @@ string attack::evasion_margin_adverb()
 void attack::stab_message()
 {
     defender->props["helpless"] = true;
+    if (defender->is_monster())
+        defender->as_monster()->info_changed();
 
     switch (stab_bonus)
     {
@@ -1076,6 +1078,8 @@ void attack::stab_message()
     }
 
     defender->props.erase("helpless");
+    if (defender->is_monster())
+        defender->as_monster()->info_changed();
 }
 
 /* Returns the attacker's name
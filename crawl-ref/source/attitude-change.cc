@@ -22,6 +22,7 @@
 #include "mon-behv.h"
 #include "mon-death.h"
 #include "mon-tentacle.h"
+#include "nearby-danger.h"
 #include "religion.h"
 #include "state.h"
 #include "travel.h"
@@ -30,6 +31,8 @@
 // temporarily.
 void mons_att_changed(monster* mon)
 {
+    invalidate_threat_set();
+
     const mon_attitude_type att = mon->temp_attitude();
     const monster_type mc = mons_base_type(*mon);
 
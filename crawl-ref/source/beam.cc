@@ -77,6 +77,7 @@
 #include "tiles-build-specific.h"
 #include "transform.h"
 #include "traps.h"
+#include "turn-profile.h"
 #include "viewchar.h"
 #include "view.h"
 #include "xom.h"
@@ -1098,6 +1099,9 @@ void bolt::fire()
 {
     path_taken.clear();
 
+    if (is_tracer)
+        prof_count(PROF_TRACERS);
+
     if (special_explosion)
         special_explosion->is_tracer = is_tracer;
 
@@ -1623,7 +1623,7 @@ void dump_map(FILE *fp, bool debug, bool dist)
 
         for (int i = X_BOUND_1; i <= X_BOUND_2; i++)
             for (int j = Y_BOUND_1; j <= Y_BOUND_2; j++)
-                if (env.map_knowledge[i][j].known())
+                if (env.map_knowledge.get(coord_def(i, j)).known())
                 {
                     if (i > max_x) max_x = i;
                     if (i < min_x) min_x = i;
@@ -38,6 +38,7 @@
 #include "stringutil.h"
 #include "terrain.h"
 #include "tiledef-main.h"
+#include "turn-profile.h"
 #include "unwind.h"
 
 cloud_struct* cloud_at(coord_def pos)
@@ -488,9 +489,9 @@ static void _cloud_interacts_with_terrain(const cloud_struct &cloud)
  * @return              The rate at which the cloud's "decay" should decrease
  *                      this turn.
  */
-static int _cloud_dissipation_rate(const cloud_struct &cloud)
+static int _cloud_dissipation_rate(const cloud_struct &cloud, int time)
 {
-    int dissipate = you.time_taken;
+    int dissipate = time;
 
     // Player-created non-opaque clouds vanish instantly when outside LOS.
     // (Opaque clouds don't to prevent cloud suicide.)
@@ -510,7 +511,7 @@ static int _cloud_dissipation_rate(const cloud_struct &cloud)
 static void _dissipate_cloud(cloud_struct& cloud)
 {
     // Apply calculated rate to the actual cloud.
-    cloud.decay -= _cloud_dissipation_rate(cloud);
+    cloud.decay -= _cloud_dissipation_rate(cloud, you.time_taken);
 
     if (cloud.type == CLOUD_FOREST_FIRE)
         _spread_fire(cloud);
@@ -563,6 +564,8 @@ static void _handle_spectral_cloud(const cloud_struct& cloud)
 
 void manage_clouds()
 {
+    prof_timer timer(PROF_CLOUDS);
+
     // We can't iterate over env.cloud directly because _dissipate_cloud
     // will remove this cloud and invalidate our iterator.
     vector<cloud_struct *> cloud_ptrs;
@@ -660,6 +663,27 @@ void delete_all_clouds()
         delete_cloud(pos);
 }
 
+/**
+ * Let every cloud dissipate for some time in one go, without spreading, as
+ * they would have while the player was away.
+ *
+ * @param time How long they have been dissipating, in aut.
+ */
+void age_all_clouds(int time)
+{
+    vector<coord_def> gone;
+    for (auto& entry : env.cloud)
+    {
+        cloud_struct &cloud = entry.second;
+        cloud.decay -= _cloud_dissipation_rate(cloud, time);
+        if (cloud.decay < 1)
+            gone.push_back(entry.first);
+    }
+
+    for (auto pos : gone)
+        delete_cloud(pos);
+}
+
 // The current use of this function is for shifting in the abyss, so
 // that clouds get moved along with the rest of the map.
 void move_cloud(coord_def src, coord_def newpos)
@@ -26,6 +26,7 @@ cloud_type cloud_type_at(const coord_def &pos);
 bool cloud_is_yours_at(const coord_def &pos);
 
 void delete_all_clouds();
+void age_all_clouds(int time);
 void delete_cloud(coord_def p);
 void remove_tornado_clouds(mid_t whose);
 void move_cloud(coord_def src, coord_def newpos);
@@ -37,6 +37,7 @@ static int  _clua_guarded_pcall(lua_State *);
 static int  _clua_require(lua_State *);
 static int  _clua_dofile(lua_State *);
 static int  _clua_loadfile(lua_State *);
+static int  _clua_new_global(lua_State *);
 static string _get_persist_file();
 
 CLua::CLua(bool managed)
@@ -46,7 +47,7 @@ CLua::CLua(bool managed)
       throttle_sleep_end(800), n_throttle_sleeps(0), mixed_call_depth(0),
       lua_call_depth(0), max_mixed_call_depth(8),
       max_lua_call_depth(100), memory_used(0),
-      _state(nullptr), sourced_files(), uniqindex(0)
+      _state(nullptr), sourced_files(), uniqindex(0), bind_generation(1)
 {
 }
 
@@ -246,6 +247,8 @@ void CLua::init_throttle()
 
 int CLua::loadbuffer(const char *buf, size_t size, const char *context)
 {
+    // New code may well redefine hooks.
+    unbind_functions();
     const int err = luaL_loadbuffer(state(), buf, size, context);
     set_error(err, state());
     return err;
@@ -299,6 +302,8 @@ int CLua::loadfile(lua_State *ls, const char *filename, bool trusted,
         return -1;
     }
 
+    get_vm(ls).unbind_functions();
+
     FileLineInput f(file.c_str());
     string script;
     while (!f.eof())
@@ -615,10 +620,49 @@ bool CLua::proc_returns(const char *par) const
 // "a.b.c" names in tables, so you can pushglobal("dgn.point") and get
 // _G['dgn']['point'], as expected.
 //
+// Simple names that turn out to be functions (or missing) are remembered
+// until unbind_functions(), so that hooks are found without splitting the
+// name or going through metamethods; a raw lookup still makes sure the
+// name hasn't been reassigned since.
+//
 // Guarantees to push exactly one value onto the stack.
 //
 void CLua::pushglobal(const string &name)
 {
+    if (name.find('.') == string::npos)
+    {
+        lua_State *ls(state());
+        bound_function &bound = bound_functions[name];
+        if (bound.generation == bind_generation)
+        {
+            // Lua code may have assigned something else to the name since
+            // (ready = other_fn, ch_stop_running = nil), which __newindex
+            // doesn't hear about: check with one raw lookup.
+            lua_rawgeti(ls, LUA_REGISTRYINDEX, bound.ref);
+            lua_pushstring(ls, name.c_str());
+            lua_rawget(ls, LUA_GLOBALSINDEX);
+            if (lua_rawequal(ls, -1, -2))
+            {
+                lua_pop(ls, 1);
+                return;
+            }
+            lua_pop(ls, 2);
+        }
+
+        if (bound.generation)
+            luaL_unref(ls, LUA_REGISTRYINDEX, bound.ref);
+        bound.generation = 0;
+
+        lua_getglobal(ls, name.c_str());
+        if (lua_isfunction(ls, -1) || lua_isnil(ls, -1))
+        {
+            lua_pushvalue(ls, -1);
+            bound.ref = luaL_ref(ls, LUA_REGISTRYINDEX);
+            bound.generation = bind_generation;
+        }
+        return;
+    }
+
     vector<string> pieces = split_string(".", name);
     lua_State *ls(state());
 
@@ -651,6 +695,17 @@ void CLua::pushglobal(const string &name)
     }
 }
 
+/**
+ * Forget the functions bound by pushglobal(). Called whenever Lua code is
+ * loaded and whenever a new global is created, either of which might
+ * define a hook. A hook that already exists and is replaced by plain
+ * assignment is caught by pushglobal() itself.
+ */
+void CLua::unbind_functions()
+{
+    ++bind_generation;
+}
+
 bool CLua::callfn(const char *fn, const char *params, ...)
 {
     error.clear();
@@ -775,6 +830,12 @@ void CLua::init_lua()
 
     lua_pushlightuserdata(_state, this);
     setregistry("__clua");
+
+    // Hear about new globals, for pushglobal().
+    lua_newtable(_state);
+    lua_pushcfunction(_state, _clua_new_global);
+    lua_setfield(_state, -2, "__newindex");
+    lua_setmetatable(_state, LUA_GLOBALSINDEX);
 }
 
 static int lua_loadstring(lua_State *ls)
@@ -838,6 +899,13 @@ void CLua::init_libraries()
     }
 }
 
+static int _clua_new_global(lua_State *ls)
+{
+    lua_rawset(ls, 1);
+    CLua::get_vm(ls).unbind_functions();
+    return 0;
+}
+
 CLua &CLua::get_vm(lua_State *ls)
 {
     lua_stack_cleaner clean(ls);
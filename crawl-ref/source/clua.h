@@ -11,6 +11,7 @@ extern "C" {
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 #include "maybe-bool.h"
 
@@ -123,6 +124,7 @@ public:
                  bool force = false);
 
     void pushglobal(const string &name);
+    void unbind_functions();
 
     maybe_bool callmbooleanfn(const char *fn, const char *params, ...);
     maybe_bool callmaybefn(const char *fn, const char *params, ...);
@@ -175,6 +177,17 @@ private:
 
     vector<lua_shutdown_listener*> shutdown_listeners;
 
+    // Global functions found by pushglobal(), kept as registry references so
+    // that hooks which run all the time needn't be looked up by name. They
+    // are only good while bind_generation hasn't moved on.
+    struct bound_function
+    {
+        int ref;
+        unsigned int generation;
+    };
+    unordered_map<string, bound_function> bound_functions;
+    unsigned int bind_generation;
+
 private:
     void init_lua();
     void set_error(int err, lua_State *ls = nullptr);
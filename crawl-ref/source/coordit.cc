@@ -167,22 +167,93 @@ void random_rectangle_iterator::operator++(int)
 /*
  *  radius iterator
  */
+static int _radius_credit(int r, circle_type ctype)
+{
+    switch (ctype)
+    {
+    case C_CIRCLE: return r;
+    case C_POINTY: return r * r;
+    case C_ROUND:  return r * r + 1;
+    case C_SQUARE: return r;
+    }
+    return r;
+}
+
+// Offset tables, by whether the shape is a square and by credit. Iterators
+// keep pointers to the tables, so they mustn't move when more are added.
+static vector<unique_ptr<vector<coord_def>>> radius_tables[2];
+
+/**
+ * The offsets visited for a shape, in order: from the center outwards row
+ * by row, each row walking outwards from the middle column, and for each
+ * x,y going SE, NE, SW, NW. Cells which fall off the map are skipped by the
+ * iterator itself, so one table serves every center.
+ */
+static const vector<coord_def> &_radius_table(int credit, bool is_square)
+{
+    // Any negative credit gives just the center, as 0 does.
+    credit = max(credit, 0);
+
+    auto &tables = radius_tables[is_square];
+    if ((int) tables.size() <= credit)
+        tables.resize(credit + 1);
+
+    if (tables[credit])
+        return *tables[credit];
+    tables[credit].reset(new vector<coord_def>);
+    vector<coord_def> &table = *tables[credit];
+
+    const int base_cost = is_square ? 1 : -1;
+    const int inc_cost = is_square ? 0 : 2;
+
+    int y = 0;
+    int cost_y = base_cost;
+    int credit_y = credit;
+    do
+    {
+        int x = 0;
+        int cost_x = base_cost;
+        int credit_x = (is_square ? credit : credit_y);
+
+        do
+        {
+            table.emplace_back(x, y);
+            if (y)
+                table.emplace_back(x, -y);
+            if (x)
+            {
+                table.emplace_back(-x, y);
+                if (y)
+                    table.emplace_back(-x, -y);
+            }
+            x++;
+            credit_x -= (cost_x += inc_cost);
+        } while (credit_x >= 0);
+
+        y++;
+        credit_y -= (cost_y += inc_cost);
+    } while (credit_y >= 0);
+
+    return table;
+}
+
+/// The offsets a radius_iterator of this size and shape visits, in order,
+/// before any are dropped for being off the map or out of LOS.
+const vector<coord_def> &radius_offsets(int radius, circle_type ctype)
+{
+    return _radius_table(_radius_credit(radius, ctype), ctype == C_SQUARE);
+}
+
 radius_iterator::radius_iterator(const coord_def _center, int r,
                                  circle_type ctype,
                                  bool _exclude_center)
-    : state(RI_START),
+    : visible(nullptr),
+      offsets(&radius_offsets(r, ctype)),
+      index(-1),
       center(_center),
       los(LOS_NONE)
 {
     ASSERT(map_bounds(_center));
-    switch (ctype)
-    {
-    case C_CIRCLE: credit = r; break;
-    case C_POINTY: credit = r * r; break;
-    case C_ROUND:  credit = r * r + 1; break;
-    case C_SQUARE: credit = r; break;
-    }
-    is_square = (ctype == C_SQUARE);
     ++(*this);
     if (_exclude_center)
         ++(*this);
@@ -191,13 +262,13 @@ radius_iterator::radius_iterator(const coord_def _center, int r,
 radius_iterator::radius_iterator(const coord_def _center,
                                  los_type _los,
                                  bool _exclude_center)
-    : state(RI_START),
+    : visible(nullptr),
+      offsets(&_radius_table(get_los_radius(), true)),
+      index(-1),
       center(_center),
       los(_los)
 {
     ASSERT(map_bounds(_center));
-    credit = get_los_radius();
-    is_square = true;
     ++(*this);
     if (_exclude_center)
         ++(*this);
@@ -208,19 +279,13 @@ radius_iterator::radius_iterator(const coord_def _center,
                                  circle_type ctype,
                                  los_type _los,
                                  bool _exclude_center)
-    : state(RI_START),
+    : visible(nullptr),
+      offsets(&radius_offsets(r, ctype)),
+      index(-1),
       center(_center),
       los(_los)
 {
     ASSERT(map_bounds(_center));
-    switch (ctype)
-    {
-    case C_CIRCLE: credit = r; break;
-    case C_POINTY: credit = r * r; break;
-    case C_ROUND:  credit = r * r + 1; break;
-    case C_SQUARE: credit = r; break;
-    }
-    is_square = (ctype == C_SQUARE);
     ++(*this);
     if (_exclude_center)
         ++(*this);
@@ -228,7 +293,7 @@ radius_iterator::radius_iterator(const coord_def _center,
 
 radius_iterator::operator bool() const
 {
-    return state;
+    return index < (int) offsets->size();
 }
 
 coord_def radius_iterator::operator *() const
@@ -241,59 +306,25 @@ const coord_def* radius_iterator::operator->() const
     return &current;
 }
 
-#define coreturn(id) { state = id; return; case id:; }
-#define cobegin(id)  switch (state) { case id:
-#define coend(id)    coreturn(id); }
-#define ret_coord(dx, dy, id) do                                \
-    {                                                           \
-        current.x = center.x + (dx);                            \
-        current.y = center.y + (dy);                            \
-        if (!los || cell_see_cell(center, current, los))        \
-            coreturn(id);                                       \
-    } while (0)
-
 void radius_iterator::operator++()
 {
-    cobegin(RI_START);
-
-    base_cost = is_square ? 1 : -1;
-    inc_cost = is_square ? 0 : 2;
-
-    y = 0;
-    cost_y = base_cost;
-    credit_y = credit;
-
-    do
+    while (++index < (int) offsets->size())
     {
-        x = 0;
-        cost_x = base_cost;
-        credit_x = (is_square ? credit : credit_y);
+        const coord_def d = (*offsets)[index];
+        current = center + d;
+        if (!map_bounds(current))
+            continue;
 
-        do
+        if (!los)
+            return;
+        if (visible)
         {
-            if (x + center.x < GXM)
-            {
-                if (y + center.y < GYM)
-                    ret_coord( x,  y, RI_SE);
-                if (y && y <= center.y)
-                    ret_coord( x, -y, RI_NE);
-            }
-            if (x && x <= center.x)
-            {
-                if (y + center.y < GYM)
-                    ret_coord(-x,  y, RI_SW);
-                if (y && y <= center.y)
-                    ret_coord(-x, -y, RI_NW);
-            }
-            x++;
-            credit_x -= (cost_x += inc_cost);
-        } while (credit_x >= 0);
-
-        y++;
-        credit_y -= (cost_y += inc_cost);
-    } while (credit_y >= 0);
-
-    coend(RI_DONE);
+            if (d.rdist() <= LOS_MAX_RANGE && (*visible)(d))
+                return;
+        }
+        else if (cell_see_cell(center, current, los))
+            return;
+    }
 }
 
 void radius_iterator::operator++(int)
@@ -301,6 +332,27 @@ void radius_iterator::operator++(int)
     ++(*this);
 }
 
+// The cells already visited by the base constructor (at most the center)
+// were checked one by one, which gives the same answer.
+visible_radius_iterator::visible_radius_iterator(const coord_def _center,
+                                                 int r, circle_type ctype,
+                                                 los_type _los,
+                                                 bool _exclude_center)
+    : radius_iterator(_center, r, ctype, _los, _exclude_center)
+{
+    cell_see_cells(_center, _los, los_cells);
+    visible = &los_cells;
+}
+
+visible_radius_iterator::visible_radius_iterator(const coord_def _center,
+                                                 los_type _los,
+                                                 bool _exclude_center)
+    : radius_iterator(_center, _los, _exclude_center)
+{
+    cell_see_cells(_center, _los, los_cells);
+    visible = &los_cells;
+}
+
 /*
  *  adjacent iterator
  */
@@ -526,6 +578,20 @@ void coordit_tests()
         if (!map_bounds(*ri))
             die("radius_iterator(R7) out of bounds at %d, %d", ri->x, ri->y);
 
+    for (int r = 0; r <= los_radius; ++r)
+    {
+        radius_iterator ri(center, r, C_SQUARE, LOS_SOLID);
+        visible_radius_iterator vi(center, r, C_SQUARE, LOS_SOLID);
+        for (; ri && vi; ++ri, ++vi)
+            if (*ri != *vi)
+            {
+                die("visible_radius_iterator(S%d) mismatch: %d,%d != %d,%d",
+                    r, vi->x, vi->y, ri->x, ri->y);
+            }
+        if (ri || vi)
+            die("visible_radius_iterator(S%d) has a different length", r);
+    }
+
     seen.reset();
     int rd = 0;
     for (distance_iterator di(center, true, false, BC - 1); di; ++di)
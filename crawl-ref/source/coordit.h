@@ -1,6 +1,7 @@
 #pragma once
 
 #include "coord-circle.h"
+#include "los.h"
 #include "los-type.h"
 
 class rectangle_iterator : public iterator<forward_iterator_tag, coord_def>
@@ -56,6 +57,9 @@ private:
  * The region can be a circle of any r²; furthermore, the cells can
  * be restricted to lie within LOS from the center (of any type)
  * centered at the same point), and to exclude the center.
+ *
+ * The offsets of each shape are worked out once, on first use, and shared
+ * by all iterators of that shape.
  */
 class radius_iterator : public iterator<forward_iterator_tag, coord_def>
 {
@@ -74,17 +78,40 @@ public:
     void operator ++ ();
     void operator ++ (int);
 
+protected:
+    const los_grid *visible;  // if set, LOS was looked up in advance
+
 private:
-    enum costate { RI_DONE, RI_START, RI_SE, RI_NE, RI_SW, RI_NW };
-    int x, y, cost_x, cost_y, credit, credit_x, credit_y, base_cost, inc_cost;
-    bool is_square;
+    const vector<coord_def> *offsets;
+    int index;
 
-    costate state;
     coord_def center;
     los_type los;
     coord_def current;    // storage for operator->
 };
 
+/**
+ * @class visible_radius_iterator
+ * A radius_iterator which looks up the LOS of the whole region in one go
+ * (with cell_see_cells) rather than cell by cell. It visits the same cells
+ * in the same order, but only as long as the loop doesn't change what can
+ * be seen: don't use it while creating or destroying walls.
+ */
+class visible_radius_iterator : public radius_iterator
+{
+public:
+    visible_radius_iterator(const coord_def center, int radius,
+                            circle_type ctype, los_type los,
+                            bool exclude_center = false);
+    visible_radius_iterator(const coord_def center, los_type los,
+                            bool exclude_center = false);
+
+private:
+    los_grid los_cells;
+};
+
+const vector<coord_def> &radius_offsets(int radius, circle_type ctype);
+
 class adjacent_iterator : public iterator<forward_iterator_tag, coord_def>
 {
 public:
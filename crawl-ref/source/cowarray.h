@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @brief Fixed size 2D array whose copies share storage until written to.
+ *
+ * The array is split into square blocks. Copying it only copies pointers
+ * to the blocks; writing to a cell first gives this array its own copy of
+ * that cell's block if another array still shares it. Snapshots of a whole
+ * level grid are therefore cheap, and two arrays that came from the same
+ * one can tell which blocks either has written to since.
+ *
+ * Non-const access counts as a write, so read through a const reference
+ * where that matters.
+**/
+
+#pragma once
+
+#include <memory>
+
+#include "fixedvector.h"
+
+template <class TYPE, int WIDTH, int HEIGHT> class CowArray
+{
+public:
+    typedef TYPE            value_type;
+    typedef TYPE&           reference;
+    typedef const TYPE&     const_reference;
+
+    // Width and height of a block, in cells.
+    static const int BLOCK_SIZE = 8;
+    static const int BLOCKS_X = (WIDTH + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    static const int BLOCKS_Y = (HEIGHT + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+public:
+    CowArray()
+    {
+        for (auto &block : mBlocks)
+            block = make_shared<Block>();
+    }
+
+    CowArray(TYPE def)
+    {
+        init(def);
+    }
+
+public:
+    // ----- Size -----
+    bool empty() const { return WIDTH == 0 || HEIGHT == 0; }
+    int size() const { return WIDTH*HEIGHT; }
+    int width() const { return WIDTH; }
+    int height() const { return HEIGHT; }
+
+    // ----- Access -----
+    template<class Indexer>
+    TYPE& operator () (const Indexer &i)
+    {
+        return cell(i.x, i.y);
+    }
+
+    template<class Indexer>
+    const TYPE& operator () (const Indexer &i) const
+    {
+        return cell(i.x, i.y);
+    }
+
+    // Read a cell without unsharing its block, even from a non-const array.
+    template<class Indexer>
+    const TYPE& get(const Indexer &i) const
+    {
+        return cell(i.x, i.y);
+    }
+
+    TYPE& cell(int x, int y)
+    {
+        ASSERT_RANGE(x, 0, WIDTH);
+        ASSERT_RANGE(y, 0, HEIGHT);
+        shared_ptr<Block> &block = _block(x, y);
+        if (block.use_count() > 1)
+            block = make_shared<Block>(*block);
+        return block->cells[x % BLOCK_SIZE][y % BLOCK_SIZE];
+    }
+
+    const TYPE& cell(int x, int y) const
+    {
+        ASSERT_RANGE(x, 0, WIDTH);
+        ASSERT_RANGE(y, 0, HEIGHT);
+        return _block(x, y)->cells[x % BLOCK_SIZE][y % BLOCK_SIZE];
+    }
+
+    // Every block starts out as the same shared one.
+    void init(const TYPE& def)
+    {
+        shared_ptr<Block> block = make_shared<Block>();
+        for (auto &col : block->cells)
+            col.init(def);
+        for (auto &b : mBlocks)
+            b = block;
+    }
+
+    /// Does this array still share every block with other? If so, neither
+    /// has been written to since one was copied from the other.
+    bool shares_blocks(const CowArray &other) const
+    {
+        for (int b = 0; b < BLOCKS_X * BLOCKS_Y; ++b)
+            if (mBlocks[b] != other.mBlocks[b])
+                return false;
+        return true;
+    }
+
+    /**
+     * Call f(x, y) for every cell of every block that this array and other
+     * don't share. Cells that were written to but not changed are included;
+     * cells outside those blocks are the same in both arrays.
+     */
+    template<class F>
+    void for_each_changed(const CowArray &other, F f) const
+    {
+        for (int by = 0; by < BLOCKS_Y; ++by)
+            for (int bx = 0; bx < BLOCKS_X; ++bx)
+            {
+                const int b = by * BLOCKS_X + bx;
+                if (mBlocks[b] == other.mBlocks[b])
+                    continue;
+
+                const int xend = min(WIDTH, (bx + 1) * BLOCK_SIZE);
+                const int yend = min(HEIGHT, (by + 1) * BLOCK_SIZE);
+                for (int y = by * BLOCK_SIZE; y < yend; ++y)
+                    for (int x = bx * BLOCK_SIZE; x < xend; ++x)
+                        f(x, y);
+            }
+    }
+
+protected:
+    struct Block
+    {
+        FixedVector<FixedVector<TYPE, BLOCK_SIZE>, BLOCK_SIZE> cells;
+    };
+
+    shared_ptr<Block> &_block(int x, int y)
+    {
+        return mBlocks[y / BLOCK_SIZE * BLOCKS_X + x / BLOCK_SIZE];
+    }
+
+    const shared_ptr<Block> &_block(int x, int y) const
+    {
+        return mBlocks[y / BLOCK_SIZE * BLOCKS_X + x / BLOCK_SIZE];
+    }
+
+    FixedVector<shared_ptr<Block>, BLOCKS_X * BLOCKS_Y> mBlocks;
+};
@@ -237,6 +237,7 @@ void apply_daction_to_mons(monster* mon, daction_type act, bool local,
                               | MF_NAME_NOCORPSE;
             mon->mname = "freed slave";
             mon->behaviour = hostile ? BEH_SEEK : BEH_WANDER;
+            mon->info_changed();
             break;
         }
         case DACT_KIRKE_HOGS:
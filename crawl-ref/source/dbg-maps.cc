@@ -7,13 +7,18 @@
 
 #include "dbg-maps.h"
 
+#include <chrono>
+
 #include "branch.h"
 #include "chardump.h"
 #include "crash.h"
 #include "dbg-objstat.h"
 #include "dungeon.h"
 #include "env.h"
+#include "hash.h"
 #include "initfile.h"
+#include "json.h"
+#include "json-wrapper.h"
 #include "libutil.h"
 #include "maps.h"
 #include "message.h"
@@ -22,7 +27,9 @@
 #include "shopping.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "view.h"
+#include "worker-pool.h"
 
 #ifdef DEBUG_STATISTICS
 // Map statistics generation.
@@ -537,4 +544,351 @@ void mapstat_generate_stats()
     printf("Map stats complete.\n");
 }
 
+// Vault testing: build every level a map can be placed on with that map
+// forced, in worker processes, and report how often it fails.
+
+// The outcome of testing one map, passed back from the worker process that
+// tested it.
+struct vault_test_result
+{
+    int tries;
+    int placed;
+    int build_failures; // builder() gave up on the level altogether
+    int vetoes;         // level builds thrown away before one succeeded
+    int lua_errors;
+    double seconds;
+    double max_seconds;
+    string first_error;
+    set<string> failed_levels;
+
+    vault_test_result()
+        : tries(0), placed(0), build_failures(0), vetoes(0), lua_errors(0),
+          seconds(0), max_seconds(0)
+    {
+    }
+
+    void add_try(bool success, double secs)
+    {
+        ++tries;
+        if (success)
+            ++placed;
+        seconds += secs;
+        max_seconds = max(max_seconds, secs);
+        if (!last_error.empty())
+        {
+            ++lua_errors;
+            if (first_error.empty())
+                first_error = last_error;
+        }
+    }
+
+    string serialise() const
+    {
+        string data = make_stringf("%d %d %d %d %d %.6f %.6f\n", tries,
+                                   placed, build_failures, vetoes,
+                                   lua_errors, seconds, max_seconds);
+        data += comma_separated_line(failed_levels.begin(),
+                                     failed_levels.end(), ",", ",");
+        data += "\n" + replace_all(first_error, "\n", " ");
+        return data;
+    }
+
+    bool deserialise(const string &data)
+    {
+        const vector<string> lines = split_string("\n", data, false, true,
+                                                  2);
+        if (lines.empty()
+            || sscanf(lines[0].c_str(), "%d %d %d %d %d %lf %lf", &tries,
+                      &placed, &build_failures, &vetoes, &lua_errors,
+                      &seconds, &max_seconds) != 7)
+        {
+            return false;
+        }
+        if (lines.size() > 1)
+        {
+            for (const string &level : split_string(",", lines[1]))
+                failed_levels.insert(level);
+        }
+        if (lines.size() > 2)
+            first_error = lines[2];
+        return true;
+    }
+};
+
+static vector<const map_def *> vault_test_maps;
+static uint64_t vault_test_seed = 0;
+
+static bool _vault_test_wanted(const map_def &map)
+{
+    if (SysEnv.vault_test_maps.empty())
+        return !map.has_tag("dummy");
+
+    for (const string &want : SysEnv.vault_test_maps)
+    {
+        if (want == map.name || want == map.file
+            || want + ".des" == map.file)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static vector<level_id> _vault_test_levels(const map_def &map)
+{
+    vector<level_id> levels;
+    for (const level_id &lid : generated_levels)
+        if (map.depths.is_usable_in(lid) || map.place.is_usable_in(lid))
+            levels.push_back(lid);
+    return levels;
+}
+
+static bool _vault_placed(const string &name)
+{
+    for (const auto &vp : env.level_vaults)
+        if (vp->map.name == name)
+            return true;
+    return false;
+}
+
+static double _seconds_since(chrono::steady_clock::time_point start)
+{
+    const chrono::duration<double> elapsed =
+        chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+/// Test map number `index`; called in a worker process.
+static string _vault_test_job(int index)
+{
+    const map_def *map = vault_test_maps[index];
+    const string &name = map->name;
+    // Seed from the map and try rather than from the worker, so that the
+    // results don't depend on how the maps were dealt out.
+    const uint64_t seed = vault_test_seed + hash32(name.data(), name.size());
+    const vector<level_id> levels = _vault_test_levels(*map);
+    vault_test_result result;
+
+    no_messages mx;
+
+    // Maps that can't be placed by depth (portal and branch entry vaults,
+    // subvaults, ...) can still have their Lua run.
+    if (levels.empty())
+    {
+        for (int i = 0; i < SysEnv.map_gen_iters; ++i)
+        {
+            seed_rng(seed + i);
+            last_error.clear();
+            const auto start = chrono::steady_clock::now();
+            bool ok;
+            try
+            {
+                ok = mapstat_resolve_map(map);
+            }
+            catch (const map_load_exception &err)
+            {
+                last_error = err.what();
+                ok = false;
+            }
+            result.add_try(ok, _seconds_since(start));
+        }
+        return result.serialise();
+    }
+
+    const char *prop = map->is_minivault() ? "force_minivault" : "force_map";
+    int try_num = 0;
+    for (const level_id &lid : levels)
+    {
+        for (int i = 0; i < SysEnv.map_gen_iters; ++i)
+        {
+            watchdog();
+            seed_rng(seed + try_num++);
+            dlua.callfn("dgn_clear_data", "");
+            you.uniq_map_tags.clear();
+            you.uniq_map_names.clear();
+            you.unique_creatures.reset();
+            you.where_are_you = lid.branch;
+            you.depth = lid.depth;
+            you.props[prop] = name;
+            last_error.clear();
+
+            const int vetoes_before = level_vetoes;
+            const auto start = chrono::steady_clock::now();
+            const bool built = builder();
+            const double secs = _seconds_since(start);
+            you.props.erase(prop);
+
+            const bool placed = built && _vault_placed(name);
+            if (!built)
+                ++result.build_failures;
+            if (!placed)
+                result.failed_levels.insert(lid.describe());
+            result.vetoes += level_vetoes - vetoes_before;
+            result.add_try(placed, secs);
+        }
+    }
+    return result.serialise();
+}
+
+static void _write_vault_test_report(const vector<vault_test_result> &results,
+                                     const vector<bool> &ok, double seconds)
+{
+    const string filename = SysEnv.report_file.empty()
+                            ? "vault-test.json" : SysEnv.report_file;
+    FILE *report = fopen_u(filename.c_str(), "w");
+    if (!report)
+    {
+        printf("Can't write vault test report to %s\n", filename.c_str());
+        return;
+    }
+
+    int tries = 0, failures = 0, erroring = 0, crashed = 0;
+    for (unsigned int i = 0; i < results.size(); ++i)
+    {
+        tries += results[i].tries;
+        failures += results[i].tries - results[i].placed;
+        if (results[i].lua_errors)
+            ++erroring;
+        if (!ok[i])
+            ++crashed;
+    }
+
+    const bool csv = ends_with(lowercase_string(filename), ".csv");
+    JsonNode *maps = csv ? nullptr : json_mkarray();
+    if (csv)
+    {
+        fprintf(report, "map,file,levels,tries,placed,failure_rate,"
+                        "build_failures,vetoes,lua_errors,seconds,mean_ms,"
+                        "max_ms,failed_levels,first_error\n");
+    }
+
+    for (unsigned int i = 0; i < results.size(); ++i)
+    {
+        const map_def &map = *vault_test_maps[i];
+        const vault_test_result &res = results[i];
+        const int levels = _vault_test_levels(map).size();
+        const double fail_rate = res.tries
+                                 ? (double) (res.tries - res.placed) / res.tries
+                                 : 1.0;
+        const double mean_ms = res.tries ? res.seconds * 1000 / res.tries : 0;
+        const string failed_levels =
+            comma_separated_line(res.failed_levels.begin(),
+                                 res.failed_levels.end(), " ", " ");
+        const string error = ok[i] ? res.first_error
+                                   : "worker failed while testing this map";
+
+        if (csv)
+        {
+            fprintf(report, "%s,%s,%d,%d,%d,%.4f,%d,%d,%d,%.3f,%.2f,%.2f,"
+                            "%s,\"%s\"\n",
+                    map.name.c_str(), map.file.c_str(), levels, res.tries,
+                    res.placed, fail_rate, res.build_failures, res.vetoes,
+                    res.lua_errors, res.seconds, mean_ms,
+                    res.max_seconds * 1000, failed_levels.c_str(),
+                    replace_all(error, "\"", "\"\"").c_str());
+            continue;
+        }
+
+        JsonNode *entry = json_mkobject();
+        json_append_member(entry, "name", json_mkstring(map.name.c_str()));
+        json_append_member(entry, "file", json_mkstring(map.file.c_str()));
+        json_append_member(entry, "levels", json_mknumber(levels));
+        json_append_member(entry, "tries", json_mknumber(res.tries));
+        json_append_member(entry, "placed", json_mknumber(res.placed));
+        json_append_member(entry, "failure_rate", json_mknumber(fail_rate));
+        json_append_member(entry, "build_failures",
+                           json_mknumber(res.build_failures));
+        json_append_member(entry, "vetoes", json_mknumber(res.vetoes));
+        json_append_member(entry, "lua_errors",
+                           json_mknumber(res.lua_errors));
+        if (!error.empty())
+        {
+            json_append_member(entry, "first_error",
+                               json_mkstring(error.c_str()));
+        }
+        json_append_member(entry, "seconds", json_mknumber(res.seconds));
+        json_append_member(entry, "mean_ms", json_mknumber(mean_ms));
+        json_append_member(entry, "max_ms",
+                           json_mknumber(res.max_seconds * 1000));
+        JsonNode *failed = json_mkarray();
+        for (const string &level : res.failed_levels)
+            json_append_element(failed, json_mkstring(level.c_str()));
+        json_append_member(entry, "failed_levels", failed);
+        json_append_element(maps, entry);
+    }
+
+    if (!csv)
+    {
+        JsonWrapper json(json_mkobject());
+        json_append_member(json.node, "seed",
+                           json_mkstring(to_string(vault_test_seed).c_str()));
+        json_append_member(json.node, "iterations",
+                           json_mknumber(SysEnv.map_gen_iters));
+        json_append_member(json.node, "seconds", json_mknumber(seconds));
+        json_append_member(json.node, "maps", maps);
+        fprintf(report, "%s\n", json.to_string().c_str());
+    }
+    fclose(report);
+
+    printf("Tested %u map(s) in %.1fs: %d of %d tries failed to place, "
+           "%d map(s) with Lua errors, %d worker failure(s). Report: %s\n",
+           (unsigned int) results.size(), seconds, failures, tries,
+           erroring, crashed, filename.c_str());
+}
+
+/**
+ * Test-place the maps given by -vault-test (or all of them): each map is
+ * forced onto every level its DEPTH or PLACE allows, -iters times per level
+ * with different seeds, spread over -workers processes. The map index and
+ * preludes are only loaded once, before the workers are forked.
+ */
+void mapstat_test_vaults()
+{
+    you.wizard = true;
+    you.species = SP_HUMAN;
+
+    initialise_item_descriptions();
+    initialise_branch_depths();
+    run_map_global_preludes();
+    run_map_local_preludes();
+    init_level_connectivity();
+    _dungeon_places();
+
+    for (int i = 0, size = map_count(); i < size; ++i)
+    {
+        const map_def *map = map_by_index(i);
+        if (_vault_test_wanted(*map))
+            vault_test_maps.push_back(map);
+    }
+
+    if (vault_test_maps.empty())
+    {
+        printf("No maps match '%s'.\n",
+               comma_separated_line(SysEnv.vault_test_maps.begin(),
+                                    SysEnv.vault_test_maps.end(),
+                                    ",", ",").c_str());
+        return;
+    }
+
+    reset_rng();
+    vault_test_seed = crawl_state.seed;
+
+    printf("Testing %u map(s), %d time(s) per level, with %d worker(s).\n",
+           (unsigned int) vault_test_maps.size(), SysEnv.map_gen_iters,
+           worker_count());
+    fflush(stdout);
+
+    const auto start = chrono::steady_clock::now();
+    const vector<string> data = run_worker_jobs(vault_test_maps.size(),
+                                                _vault_test_job);
+    const double seconds = _seconds_since(start);
+
+    vector<vault_test_result> results(data.size());
+    vector<bool> ok(data.size());
+    for (unsigned int i = 0; i < data.size(); ++i)
+        ok[i] = results[i].deserialise(data[i]);
+
+    _write_vault_test_report(results, ok, seconds);
+}
+
 #endif // DEBUG_STATISTICS
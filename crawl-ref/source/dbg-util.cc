@@ -16,6 +16,7 @@
 #include "macro.h"
 #include "message.h"
 #include "options.h"
+#include "prompt.h"
 #include "religion.h"
 #include "scroller.h"
 #include "shopping.h"
@@ -23,6 +24,7 @@
 #include "spl-util.h"
 #include "state.h"
 #include "stringutil.h"
+#include "turn-profile.h"
 
 monster_type debug_prompt_for_monster()
 {
@@ -142,6 +144,20 @@ void debug_show_builder_logs()
     log_scroller.show();
 }
 
+void debug_show_turn_profile()
+{
+    formatted_scroller prof_scroller;
+    prof_scroller.set_more();
+    prof_scroller.add_raw_text(prof_report(), false);
+    prof_scroller.show();
+
+    if (yesno("Reset the turn profile?", true, 'n'))
+    {
+        prof_reset();
+        mpr("Turn profile reset.");
+    }
+}
+
 string debug_coord_str(const coord_def &pos)
 {
     return make_stringf("(%d, %d)%s", pos.x, pos.y,
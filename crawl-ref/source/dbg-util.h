@@ -13,6 +13,7 @@ int debug_cap_stat(int stat);
 
 void debug_dump_levgen();
 void debug_show_builder_logs();
+void debug_show_turn_profile();
 
 struct item_def;
 string debug_art_val_str(const item_def& item);
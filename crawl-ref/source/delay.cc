@@ -279,6 +279,23 @@ bool you_are_delayed()
     return !you.delay_queue.empty();
 }
 
+/**
+ * Is a rest or wait going on that there is nothing to watch in?
+ *
+ * While no monster is in view, the turns of a rest are played out as usual
+ * but not drawn, and nothing is sent to webtiles clients. The first turn
+ * that is drawn again shows everything that changed in the meantime.
+ * Setting rest_delay to a positive value shows every turn anyway.
+ */
+bool rest_is_fast_forwarding()
+{
+    return Options.rest_delay <= 0
+           && you_are_delayed()
+           && current_delay()->is_resting()
+           && you.running.is_rest()
+           && !there_are_monsters_nearby(false, true, false);
+}
+
 shared_ptr<Delay> current_delay()
 {
     return you_are_delayed() ? you.delay_queue.front()
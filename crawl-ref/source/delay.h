@@ -731,6 +731,7 @@ void stop_delay(bool stop_stair_travel = false);
 bool you_are_delayed();
 shared_ptr<Delay> current_delay();
 void handle_delay();
+bool rest_is_fast_forwarding();
 
 bool is_being_drained(const item_def &item);
 bool is_being_butchered(const item_def &item, bool just_first = true);
@@ -23,15 +23,18 @@
 #include "initfile.h"
 #include "invent.h"
 #include "item-prop.h"
+#include "level-prefetch.h"
 #include "los.h"
 #include "macro.h"
 #include "message.h"
 #include "misc.h"
 #include "prompt.h"
 #include "religion.h"
+#include "replay.h"
 #include "startup.h"
 #include "state.h"
 #include "stringutil.h"
+#include "turn-profile.h"
 #include "view.h"
 #include "xom.h"
 #include "ui.h"
@@ -81,6 +84,7 @@ void cio_cleanup()
 // Clear some globally defined variables.
 static void _clear_globals_on_exit()
 {
+    level_prefetch_clear();
     clear_rays_on_exit();
     clear_zap_info_on_exit();
     destroy_abyss();
@@ -195,6 +199,8 @@ NORETURN void end(int exit_code, bool print_error, const char *format, ...)
         tiles.shutdown();
 #endif
 
+        replay_finish();
+        prof_write_dump();
         cio_cleanup();
         msg::deinitialise_mpr_streams();
         _clear_globals_on_exit();
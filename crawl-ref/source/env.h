@@ -4,7 +4,9 @@
 #include <memory> // unique_ptr
 
 #include "coord.h"
+#include "cowarray.h"
 #include "fprop.h"
+#include "grid-changes.h"
 #include "map-cell.h"
 #include "monster.h"
 #include "trap-def.h"
@@ -16,7 +18,7 @@ typedef set<string> string_set;
 struct vault_placement;
 typedef vector<unique_ptr<vault_placement>> vault_placement_refv;
 
-typedef FixedArray< map_cell, GXM, GYM > MapKnowledge;
+typedef CowArray< map_cell, GXM, GYM > MapKnowledge;
 
 class final_effect;
 struct crawl_environment
@@ -32,6 +34,7 @@ struct crawl_environment
     FixedArray< unsigned short, GXM, GYM >   mgrid; // monster grid
     FixedArray< int, GXM, GYM >              igrid; // item grid
     FixedArray< unsigned short, GXM, GYM >   grid_colours; // colour overrides
+    grid_change_tracker                      grid_changes; // for redraws
 
     map_mask                                 level_map_mask;
     map_mask                                 level_map_ids;
@@ -170,5 +173,5 @@ T query_map_knowledge(T default_value, const coord_def& pos, F f)
 {
     if (!map_bounds(pos))
         return default_value;
-    return f(env.map_knowledge(pos));
+    return f(env.map_knowledge.get(pos));
 }
@@ -190,7 +190,7 @@ exclude_set::exclude_set()
 void exclude_set::clear()
 {
     exclude_roots.clear();
-    exclude_points.clear();
+    exclude_points.reset();
 }
 
 void exclude_set::erase(const coord_def &p)
@@ -200,14 +200,16 @@ void exclude_set::erase(const coord_def &p)
     if (it == exclude_roots.end())
         return;
 
-    travel_exclude old_ex = it->second;
+    const int radius = it->second.radius;
     exclude_roots.erase(it);
 
-    recompute_excluded_points();
+    remark_area(p, radius);
 }
 
 void exclude_set::add_exclude(travel_exclude &ex)
 {
+    if (exclude_roots.count(ex.pos))
+        erase(ex.pos);
     add_exclude_points(ex);
     exclude_roots[ex.pos] = ex;
 }
@@ -220,40 +222,115 @@ void exclude_set::add_exclude(const coord_def &p, int radius,
     add_exclude(ex);
 }
 
+// Change the radius of the exclusion at p, if there is one.
+void exclude_set::set_radius(const coord_def &p, int radius)
+{
+    travel_exclude *ex = get_exclude_root(p);
+    if (!ex)
+        return;
+
+    const int old_radius = ex->radius;
+    ex->radius = radius;
+    ex->set_los();
+    // Marks ex itself too, whatever its new radius.
+    remark_area(p, old_radius);
+}
+
 void exclude_set::add_exclude_points(travel_exclude& ex)
+{
+    if (ex.radius > 0)
+    {
+        if (!ex.uptodate)
+            ex.set_los();
+        else
+            ex.los.update();
+    }
+
+    mark_exclude_points(ex);
+}
+
+// Mark the cells ex affects with its LOS as it is, without updating it.
+void exclude_set::mark_exclude_points(const travel_exclude& ex)
 {
     if (ex.radius == 0)
     {
-        exclude_points.insert(ex.pos);
+        exclude_points.set(ex.pos);
         return;
     }
 
-    if (!ex.uptodate)
-        ex.set_los();
-    else
-        ex.los.update();
-
     for (radius_iterator ri(ex.pos, ex.radius, C_SQUARE); ri; ++ri)
         if (ex.affects(*ri))
-            exclude_points.insert(*ri);
+            exclude_points.set(*ri);
 }
 
-void exclude_set::update_excluded_points(bool recompute_los)
+// Clear the square of the given radius around c, and mark it again from
+// every exclusion that reaches into it. Cells outside the square are left
+// alone, so this is all that's needed when one exclusion in it changes.
+// Stale exclusions are brought up to date (and their own squares marked
+// again) first, since marking from an out of date LOS would be wrong.
+void exclude_set::remark_area(const coord_def &c, int radius)
 {
-    for (iterator it = exclude_roots.begin(); it != exclude_roots.end(); ++it)
+    vector<pair<coord_def, int>> areas;
+    areas.emplace_back(c, radius);
+    update_stale_excludes(areas);
+    remark_areas(areas);
+}
+
+// Bring the exclusions whose LOS has gone stale up to date, along with
+// the cells around them.
+void exclude_set::update_excluded_points()
+{
+    vector<pair<coord_def, int>> areas;
+    update_stale_excludes(areas);
+    remark_areas(areas);
+}
+
+// Update the LOS of every stale exclusion, adding its square to areas.
+void exclude_set::update_stale_excludes(vector<pair<coord_def, int>> &areas)
+{
+    for (auto &entry : exclude_roots)
     {
-        travel_exclude &ex = it->second;
+        travel_exclude &ex = entry.second;
         if (!ex.uptodate)
         {
-            recompute_excluded_points(recompute_los);
-            return;
+            ex.set_los();
+            areas.emplace_back(ex.pos, ex.radius);
+        }
+    }
+}
+
+// Clear all the squares before marking any of them, so that clearing one
+// doesn't undo the marks made for another.
+void exclude_set::remark_areas(const vector<pair<coord_def, int>> &areas)
+{
+    for (const auto &area : areas)
+    {
+        const coord_def &c = area.first;
+        const int radius = area.second;
+        const coord_def tl(max(c.x - radius, 0), max(c.y - radius, 0));
+        const coord_def br(min(c.x + radius, GXM - 1),
+                           min(c.y + radius, GYM - 1));
+        for (rectangle_iterator ri(tl, br); ri; ++ri)
+            exclude_points.set(*ri, false);
+    }
+
+    for (const auto &entry : exclude_roots)
+    {
+        const travel_exclude &ex = entry.second;
+        for (const auto &area : areas)
+        {
+            if ((ex.pos - area.first).rdist() <= ex.radius + area.second)
+            {
+                mark_exclude_points(ex);
+                break;
+            }
         }
     }
 }
 
 void exclude_set::recompute_excluded_points(bool recompute_los)
 {
-    exclude_points.clear();
+    exclude_points.reset();
     for (iterator it = exclude_roots.begin(); it != exclude_roots.end(); ++it)
     {
         travel_exclude &ex = it->second;
@@ -265,7 +342,7 @@ void exclude_set::recompute_excluded_points(bool recompute_los)
 
 bool exclude_set::is_excluded(const coord_def &p) const
 {
-    return exclude_points.count(p);
+    return map_bounds(p) && exclude_points(p);
 }
 
 bool exclude_set::is_exclude_root(const coord_def &p) const
@@ -338,7 +415,7 @@ void update_exclusion_los(vector<coord_def> changed)
     for (coord_def c : changed)
         _mark_excludes_non_updated(c);
 
-    curr_excludes.update_excluded_points(true);
+    curr_excludes.update_excluded_points();
 }
 
 bool is_excluded(const coord_def &p, const exclude_set &exc)
@@ -450,7 +527,7 @@ void cycle_exclude_radius(const coord_def &p)
 {
     if (travel_exclude *exc = curr_excludes.get_exclude_root(p))
     {
-        if (feat_is_door(grd(p)) && env.map_knowledge(p).known())
+        if (feat_is_door(grd(p)) && env.map_knowledge.get(p).known())
         {
             _exclude_gate(p, exc->radius == 0);
             return;
@@ -491,9 +568,7 @@ void set_exclude(const coord_def &p, int radius, bool autoexcl, bool vaultexcl,
         else if (exc->radius == radius)
             return;
 
-        exc->radius   = radius;
-        exc->uptodate = false;
-        curr_excludes.recompute_excluded_points();
+        curr_excludes.set_radius(p, radius);
     }
     else
     {
@@ -502,7 +577,7 @@ void set_exclude(const coord_def &p, int radius, bool autoexcl, bool vaultexcl,
         {
             // Don't list a monster in the exclusion annotation if the
             // exclusion was triggered by e.g. the flamethrowers' lua check.
-            const map_cell& cell = env.map_knowledge(p);
+            const map_cell& cell = env.map_knowledge.get(p);
             if (cell.monster() != MONS_NO_MONSTER)
             {
                 desc = mons_type_name(cell.monster(), DESC_PLAIN);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "bitary.h"
 #include "los-def.h"
 
 void add_auto_excludes();
@@ -64,7 +65,9 @@ public:
                      string desc = "",
                      bool vaultexcl = false);
 
-    void update_excluded_points(bool recompute_los = false);
+    void set_radius(const coord_def &p, int radius);
+
+    void update_excluded_points();
     void recompute_excluded_points(bool recompute_los = false);
 
     travel_exclude* get_exclude_root(const coord_def &p);
@@ -83,13 +86,19 @@ public:
     iterator  end();
 
 private:
-    typedef set<coord_def> exclset;
+    // Every cell affected by at least one exclusion. Kept up to date as
+    // exclusions come and go, so that is_excluded() is a single lookup.
+    typedef FixedBitArray<GXM, GYM> exclgrid;
 
     exclmap exclude_roots;
-    exclset exclude_points;
+    exclgrid exclude_points;
 
 private:
     void add_exclude_points(travel_exclude& ex);
+    void mark_exclude_points(const travel_exclude& ex);
+    void remark_area(const coord_def &c, int radius);
+    void update_stale_excludes(vector<pair<coord_def, int>> &areas);
+    void remark_areas(const vector<pair<coord_def, int>> &areas);
 };
 
 extern exclude_set curr_excludes; // in travel.cc
@@ -52,6 +52,8 @@
 #include "items.h"
 #include "jobs.h"
 #include "kills.h"
+#include "level-catchup.h"
+#include "level-prefetch.h"
 #include "level-state-type.h"
 #include "libutil.h"
 #include "macro.h"
@@ -115,11 +117,16 @@ static void _ghost_dprf(const char *format, ...)
 #endif
 
 static void _save_level(const level_id& lid);
+static void _restore_level(const string &level_name);
+
+static bool _tagged_chunk_version_compatible(reader &inf, string* reason);
 
 static bool _ghost_version_compatible(const save_version &version);
 
 static bool _restore_tagged_chunk(package *save, const string &name,
                                   tag_type tag, const char* complaint);
+static bool _restore_tagged_reader(reader &inf, const string &name,
+                                   tag_type tag, const char* complaint);
 static bool _read_char_chunk(package *save);
 
 static bool _convert_obsolete_species();
@@ -1491,7 +1498,7 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
     else
     {
         dprf("Loading old level '%s'.", level_name.c_str());
-        _restore_tagged_chunk(you.save, level_name, TAG_LEVEL, "Level file is invalid.");
+        _restore_level(level_name);
         _redraw_all(); // TODO why is there a redraw call here?
     }
 
@@ -1718,6 +1725,286 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
     return just_created_level;
 }
 
+static const char *level_section_names[] =
+{
+    "grids", "items", "monsters", "tiles", "map", "state",
+};
+COMPILE_CHECK(ARRAYSZ(level_section_names) == NUM_LEVEL_SECTIONS);
+
+/// The name of the chunk holding one section of a level.
+string level_section_chunk(const string &level_name, int section)
+{
+    ASSERT_RANGE(section, 0, NUM_LEVEL_SECTIONS);
+    return level_name + "." + level_section_names[section];
+}
+
+// What a monster slot held, in the fields that change whenever the monster
+// does anything at all: spending energy, moving, being hurt or healed, or
+// anything that calls monster::info_changed().
+struct monster_stamp
+{
+    mid_t mid;
+    unsigned int version;
+    monster_type type;
+    coord_def pos;
+    coord_def target;
+    int hit_points;
+    int max_hit_points;
+    int speed_increment;
+    monster_flags_t flags;
+    mon_attitude_type attitude;
+    beh_type behaviour;
+    unsigned short foe;
+    int foe_memory;
+    unsigned int number;
+    god_type god;
+
+    monster_stamp(const monster &m)
+        : mid(m.mid), version(m.info_version), type(m.type), pos(m.pos()),
+          target(m.target), hit_points(m.hit_points),
+          max_hit_points(m.max_hit_points),
+          speed_increment(m.speed_increment), flags(m.flags),
+          attitude(m.attitude), behaviour(m.behaviour), foe(m.foe),
+          foe_memory(m.foe_memory), number(m.number), god(m.god)
+    {
+    }
+
+    bool operator==(const monster_stamp &o) const
+    {
+        return mid == o.mid && version == o.version && type == o.type
+               && pos == o.pos && target == o.target
+               && hit_points == o.hit_points
+               && max_hit_points == o.max_hit_points
+               && speed_increment == o.speed_increment && flags == o.flags
+               && attitude == o.attitude && behaviour == o.behaviour
+               && foe == o.foe && foe_memory == o.foe_memory
+               && number == o.number && god == o.god;
+    }
+};
+
+/**
+ * What the terrain, the map knowledge and the monsters of a level were when
+ * it was last loaded or saved. Comparing these with the level as it is now
+ * is much cheaper than serialising those sections, so a section that has
+ * not changed is not even serialised again.
+ */
+struct level_snapshot
+{
+    FixedArray<dungeon_feature_type, GXM, GYM> grid;
+    FixedArray<terrain_property_t, GXM, GYM> pgrid;
+    FixedArray<unsigned short, GXM, GYM> grid_colours;
+    unique_ptr<grid_heightmap> heightmap;
+    // Shares its blocks with env.map_knowledge until either is written to.
+    MapKnowledge map_knowledge;
+    unique_ptr<MapKnowledge> map_forgotten;
+    FixedVector<monster_type, MAX_MONS_ALLOC> mons_alloc;
+    vector<monster_stamp> monsters;
+    int level_time;
+
+    void take(int time);
+    bool changed(int section) const;
+
+private:
+    bool _grids_changed() const;
+    bool _map_changed() const;
+    bool _monsters_changed() const;
+};
+
+// The time the level has been brought up to, as it is saved.
+static int _level_time()
+{
+    return you.on_current_level ? you.elapsed_time : env.elapsed_time;
+}
+
+/**
+ * Remember the level as it is now.
+ *
+ * @param time The time the level has been brought up to: when it was just
+ *             loaded, the time it was saved at, since catching it up on the
+ *             time since happens later.
+ */
+void level_snapshot::take(int time)
+{
+    grid = env.grid;
+    pgrid = env.pgrid;
+    grid_colours = env.grid_colours;
+    heightmap.reset(env.heightmap ? new grid_heightmap(*env.heightmap)
+                                  : nullptr);
+
+    map_knowledge = env.map_knowledge;
+    map_forgotten.reset(env.map_forgotten
+                        ? new MapKnowledge(*env.map_forgotten) : nullptr);
+
+    mons_alloc = env.mons_alloc;
+    level_time = time;
+    monsters.clear();
+    for (int i = 0; i < MAX_MONSTERS; ++i)
+        monsters.emplace_back(menv[i]);
+}
+
+/// Might a section of the level differ from what it was in the snapshot?
+bool level_snapshot::changed(int section) const
+{
+    switch (section)
+    {
+    case LEVEL_SECTION_GRIDS:
+        return _grids_changed();
+    case LEVEL_SECTION_MAP:
+        return _map_changed();
+    case LEVEL_SECTION_MONSTERS:
+        return _monsters_changed();
+    default:
+        return true;
+    }
+}
+
+bool level_snapshot::_grids_changed() const
+{
+    for (int x = 0; x < GXM; ++x)
+        for (int y = 0; y < GYM; ++y)
+        {
+            if (grid[x][y] != env.grid[x][y]
+                || pgrid[x][y] != env.pgrid[x][y]
+                || grid_colours[x][y] != env.grid_colours[x][y])
+            {
+                return true;
+            }
+        }
+
+    if (!heightmap || !env.heightmap)
+        return !heightmap != !env.heightmap;
+    for (rectangle_iterator ri(0); ri; ++ri)
+        if ((*heightmap)(*ri) != (*env.heightmap)(*ri))
+            return true;
+    return false;
+}
+
+// Any write to the map knowledge, even one that leaves a cell as it was,
+// gives env its own copy of that block.
+bool level_snapshot::_map_changed() const
+{
+    if (!map_knowledge.shares_blocks(env.map_knowledge))
+        return true;
+    if (!map_forgotten || !env.map_forgotten)
+        return !map_forgotten != !env.map_forgotten;
+    return !map_forgotten->shares_blocks(*env.map_forgotten);
+}
+
+bool level_snapshot::_monsters_changed() const
+{
+    // Enchantments time out even on monsters that never move.
+    if (level_time != _level_time())
+        return true;
+
+    for (int i = 0; i < MAX_MONS_ALLOC; ++i)
+        if (mons_alloc[i] != env.mons_alloc[i])
+            return true;
+
+    for (int i = 0; i < MAX_MONSTERS; ++i)
+        if (!(monsters[i] == monster_stamp(menv[i])))
+            return true;
+    return false;
+}
+
+// The level that was saved or loaded last, the versions of the chunks
+// holding its sections, and what those sections held: exact copies of the
+// small ones and a snapshot of the level for the rest.
+static string cached_level;
+static vector<vector<unsigned char>> cached_sections;
+static vector<uint32_t> cached_versions;
+static level_snapshot cached_snapshot;
+
+// Sections whose changes cached_snapshot notices without serialising them.
+static bool _level_section_tracked(int section)
+{
+    return section == LEVEL_SECTION_GRIDS || section == LEVEL_SECTION_MAP
+           || section == LEVEL_SECTION_MONSTERS;
+}
+
+static void _remember_level_sections(const string &level_name,
+                                     vector<vector<unsigned char>> &sections,
+                                     int level_time)
+{
+    cached_level = level_name;
+    cached_sections.swap(sections);
+    cached_versions.clear();
+    for (int i = 0; i < NUM_LEVEL_SECTIONS; ++i)
+    {
+        cached_versions.push_back(
+            you.save->chunk_version(level_section_chunk(level_name, i)));
+        if (_level_section_tracked(i))
+            vector<unsigned char>().swap(cached_sections[i]);
+    }
+    cached_snapshot.take(level_time);
+}
+
+// Saved in an older format: every section needs writing anew.
+static void _forget_level_sections()
+{
+    cached_level.clear();
+    cached_sections.clear();
+    cached_versions.clear();
+}
+
+// Is the chunk holding this section still the one saved or loaded last?
+// Chunk versions are never reused, so a matching version means nothing has
+// replaced the chunk since.
+static bool _level_chunk_current(const string &level_name, int section)
+{
+    return level_name == cached_level
+           && cached_versions[section] != 0
+           && cached_versions[section]
+              == you.save->chunk_version(level_section_chunk(level_name,
+                                                             section));
+}
+
+/**
+ * Save the current level as one chunk per section, plus a small chunk under
+ * the level's own name with the version. Sections that are the same as the
+ * ones already in the save (e.g. the terrain of a level the player only
+ * walked through) are left alone rather than compressed and written again;
+ * the terrain, map knowledge and monsters are not even serialised then.
+ */
+static void _write_level_chunks(const string &level_name)
+{
+    FixedBitVector<NUM_LEVEL_SECTIONS> wanted;
+    for (int i = 0; i < NUM_LEVEL_SECTIONS; ++i)
+    {
+        if (!_level_section_tracked(i)
+            || !_level_chunk_current(level_name, i)
+            || cached_snapshot.changed(i))
+        {
+            wanted.set(i);
+        }
+    }
+
+    vector<vector<unsigned char>> sections;
+    tag_write_level_sections(sections, wanted);
+
+    for (int i = 0; i < NUM_LEVEL_SECTIONS; ++i)
+    {
+        if (!wanted[i]
+            || !_level_section_tracked(i)
+               && _level_chunk_current(level_name, i)
+               && cached_sections[i] == sections[i])
+        {
+            continue;
+        }
+
+        writer outf(you.save, level_section_chunk(level_name, i));
+        outf.write(&sections[i][0], sections[i].size());
+    }
+
+    {
+        writer outf(you.save, level_name);
+        marshallUByte(outf, TAG_MAJOR_VERSION);
+        marshallUByte(outf, TAG_MINOR_VERSION);
+        marshallInt(outf, NUM_LEVEL_SECTIONS);
+    }
+
+    _remember_level_sections(level_name, sections, _level_time());
+}
+
 static void _save_level(const level_id& lid)
 {
     travel_cache.get_level_info(lid).update();
@@ -1725,7 +2012,72 @@ static void _save_level(const level_id& lid)
     // Nail all items to the ground.
     fix_item_coordinates();
 
-    _write_tagged_chunk(lid.describe(), TAG_LEVEL);
+    _write_level_chunks(lid.describe());
+}
+
+// Get a level chunk decompressed, from the prefetcher if it has it.
+static void _read_level_chunk(const string &name, vector<unsigned char> &data)
+{
+    if (take_prefetched_level(name, data))
+        return;
+
+    chunk_reader inf(you.save, name);
+    vector<char> buf;
+    inf.read_all(buf);
+    data.assign(buf.begin(), buf.end());
+}
+
+static void _restore_level(const string &level_name)
+{
+    vector<unsigned char> buf;
+    _read_level_chunk(level_name, buf);
+
+    reader inf(buf);
+    string reason;
+    if (!_tagged_chunk_version_compatible(inf, &reason))
+        end(-1, false, "\nLevel file is invalid. %s\n", reason.c_str());
+
+#if TAG_MAJOR_VERSION == 34
+    // Saved before levels were split into sections.
+    if (inf.getMinorVersion() < TAG_MINOR_LEVEL_SECTIONS)
+    {
+        reader whole(buf);
+        _restore_tagged_reader(whole, level_name, TAG_LEVEL,
+                               "Level file is invalid.");
+        _forget_level_sections();
+        return;
+    }
+
+    // Saved before the map and the level state had sections of their own.
+    const int num_sections =
+        inf.getMinorVersion() < TAG_MINOR_LEVEL_MAP_SECTIONS
+            ? LEVEL_SECTION_MAP : NUM_LEVEL_SECTIONS;
+#else
+    const int num_sections = NUM_LEVEL_SECTIONS;
+#endif
+
+    if (unmarshallInt(inf) != num_sections)
+        end(-1, false, "\nLevel file is invalid. Bad section count.\n");
+    inf.fail_if_not_eof(level_name);
+
+    vector<vector<unsigned char>> sections(NUM_LEVEL_SECTIONS);
+    for (int i = 0; i < num_sections; ++i)
+        _read_level_chunk(level_section_chunk(level_name, i), sections[i]);
+
+    crawl_state.minor_version = inf.getMinorVersion();
+    try
+    {
+        tag_read_level_sections(sections, inf.getMinorVersion());
+    }
+    catch (short_read_exception &E)
+    {
+        fail("truncated save chunk (%s)", level_name.c_str());
+    };
+
+    if (num_sections < NUM_LEVEL_SECTIONS)
+        _forget_level_sections();
+    else
+        _remember_level_sections(level_name, sections, env.elapsed_time);
 }
 
 #if TAG_MAJOR_VERSION == 34
@@ -2544,7 +2896,11 @@ void delete_level(const level_id &level)
     clear_level_annotations(level);
 
     if (you.save)
+    {
         you.save->delete_chunk(level.describe());
+        for (int i = 0; i < NUM_LEVEL_SECTIONS; ++i)
+            you.save->delete_chunk(level_section_chunk(level.describe(), i));
+    }
 
     auto &visited = you.props[VISITED_LEVELS_KEY].get_table();
     visited.erase(level.describe());
@@ -2739,6 +3095,12 @@ static bool _restore_tagged_chunk(package *save, const string &name,
                                   tag_type tag, const char* complaint)
 {
     reader inf(save, name);
+    return _restore_tagged_reader(inf, name, tag, complaint);
+}
+
+static bool _restore_tagged_reader(reader &inf, const string &name,
+                                   tag_type tag, const char* complaint)
+{
     string reason;
     if (!_tagged_chunk_version_compatible(inf, &reason))
     {
@@ -85,6 +85,7 @@ bool generate_level(const level_id &l);
 bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
                 const level_id& old_level);
 void delete_level(const level_id &level);
+string level_section_chunk(const string &level_name, int section);
 
 void save_game(bool leave_game, const char *bye = nullptr);
 
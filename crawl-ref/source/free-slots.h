@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @brief Hand out free slots of a fixed size array without scanning it.
+**/
+
+#pragma once
+
+#include <vector>
+
+/**
+ * A list of the slots of an array (mitm, menv) that were free when last
+ * looked at.
+ *
+ * Slots are freed all over the code without telling anyone, and whole
+ * arrays get replaced on level changes, so the list is only a hint: a slot
+ * is checked before it is handed out, and when the list runs dry it is
+ * rebuilt with one scan of the array. Slots freed through the usual
+ * functions are given back straight away. Most allocations thus take
+ * constant time, and a slot freed behind the list's back is found again at
+ * the next scan.
+ *
+ * A rebuilt list hands out the lowest free slot first, as a plain scan
+ * would.
+ */
+class free_slot_list
+{
+public:
+    /**
+     * Take a free slot.
+     *
+     * @param size    The size of the array.
+     * @param limit   Only slots below this are handed out.
+     * @param is_free Whether a slot is free.
+     * @return The slot, or -1 if there is no free slot below limit.
+     */
+    template <class F>
+    int take(int size, int limit, F is_free)
+    {
+        vector<int> too_high;
+        int slot = -1;
+        for (int pass = 0; pass < 2 && slot == -1; ++pass)
+        {
+            if (pass)
+                _rebuild(size, is_free);
+
+            while (!m_slots.empty())
+            {
+                const int next = m_slots.back();
+                m_slots.pop_back();
+                if (!is_free(next))
+                    continue;
+                if (next < limit)
+                {
+                    slot = next;
+                    break;
+                }
+                too_high.push_back(next);
+            }
+        }
+
+        m_slots.insert(m_slots.end(), too_high.rbegin(), too_high.rend());
+        return slot;
+    }
+
+    /// A slot has just been freed; hand it out next.
+    void give_back(int slot)
+    {
+        // Nothing is lost by forgetting: the next scan finds them again.
+        if (m_slots.size() >= MAX_SLOT_HINTS)
+            m_slots.clear();
+        m_slots.push_back(slot);
+    }
+
+    void clear()
+    {
+        m_slots.clear();
+    }
+
+private:
+    static const size_t MAX_SLOT_HINTS = 4096;
+
+    template <class F>
+    void _rebuild(int size, F is_free)
+    {
+        m_slots.clear();
+        for (int i = size - 1; i >= 0; --i)
+            if (is_free(i))
+                m_slots.push_back(i);
+    }
+
+    vector<int> m_slots;
+};
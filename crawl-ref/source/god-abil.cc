@@ -45,6 +45,7 @@
 #include "item-status-flag-type.h"
 #include "items.h"
 #include "item-use.h"
+#include "level-catchup.h"
 #include "level-state-type.h"
 #include "libutil.h"
 #include "losglobal.h"
@@ -1876,6 +1877,7 @@ void yred_make_enslaved_soul(monster* mon, bool force_hostile)
         mon->props[CUSTOM_SPELLS_KEY] = true;
 
     name_zombie(*mon, orig);
+    mon->info_changed();
 
     mons_make_god_gift(*mon, GOD_YREDELEMNUL);
     add_companion(mon);
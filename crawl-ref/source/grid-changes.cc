@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief Notice which cells of the level grids have changed between looks.
+**/
+
+#include "AppHdr.h"
+
+#include "grid-changes.h"
+
+#include "env.h"
+
+bool grid_cell_state::operator==(const grid_cell_state &other) const
+{
+    return feat == other.feat && colour == other.colour
+           && props == other.props && mons == other.mons
+           && item == other.item && cloud == other.cloud;
+}
+
+grid_change_tracker::grid_change_tracker()
+{
+    reset();
+}
+
+/// Forget what the grids held: every cell counts as changed next time.
+void grid_change_tracker::reset()
+{
+    grid_cell_state unknown;
+    unknown.feat   = NUM_FEATURES;
+    unknown.colour = 0;
+    unknown.props  = terrain_property_t();
+    unknown.mons   = NON_MONSTER;
+    unknown.item   = NON_ITEM;
+    unknown.cloud  = false;
+
+    m_level = level_id();
+    m_state.init(unknown);
+    m_clouds.reset();
+}
+
+/**
+ * Start looking at the level anew. Starts over if the level is not the one
+ * looked at last time.
+ */
+void grid_change_tracker::start_look()
+{
+    if (m_level != level_id::current())
+    {
+        reset();
+        m_level = level_id::current();
+    }
+
+    // Far fewer clouds than cells, so find them all at once rather than
+    // looking each cell up in env.cloud.
+    m_clouds.reset();
+    for (const auto &entry : env.cloud)
+        m_clouds.set(entry.first);
+}
+
+/**
+ * Has a cell changed since it was last checked? Either way, remember what
+ * it holds now.
+ *
+ * @param p The cell to check.
+ * @return Whether the cell changed.
+ */
+bool grid_change_tracker::check(const coord_def &p)
+{
+    const grid_cell_state now = _state_at(p);
+    if (now == m_state(p))
+        return false;
+
+    m_state(p) = now;
+    return true;
+}
+
+grid_cell_state grid_change_tracker::_state_at(const coord_def &p) const
+{
+    grid_cell_state state;
+    state.feat   = env.grid(p);
+    state.colour = env.grid_colours(p);
+    state.props  = env.pgrid(p);
+    state.mons   = env.mgrid(p);
+    state.item   = env.igrid(p);
+    state.cloud  = m_clouds.get(p);
+    return state;
+}
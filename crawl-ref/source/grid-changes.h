@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @brief Notice which cells of the level grids have changed between looks.
+**/
+
+#pragma once
+
+#include "bitary.h"
+#include "fprop.h"
+
+// What the level grids held at one cell: the terrain, its colour and
+// properties, the monster and the top item there, and whether it had a cloud.
+struct grid_cell_state
+{
+    dungeon_feature_type feat;
+    unsigned short       colour;
+    terrain_property_t   props;
+    unsigned short       mons;
+    int                  item;
+    bool                 cloud;
+
+    bool operator==(const grid_cell_state &other) const;
+    bool operator!=(const grid_cell_state &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Tracks changes to env.grid, env.grid_colours, env.pgrid, env.mgrid,
+ * env.igrid and the clouds of the current level.
+ *
+ * Those are written to from all over the place, so rather than catching the
+ * writes, each cell looked at is compared with what it held the last time.
+ * Moving to another level starts over, with every cell counting as changed.
+ */
+class grid_change_tracker
+{
+public:
+    grid_change_tracker();
+
+    void reset();
+    void start_look();
+    bool check(const coord_def &p);
+
+private:
+    grid_cell_state _state_at(const coord_def &p) const;
+
+    level_id                              m_level;
+    FixedArray<grid_cell_state, GXM, GYM> m_state;
+    FixedBitArray<GXM, GYM>               m_clouds;
+};
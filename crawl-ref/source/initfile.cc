@@ -52,6 +52,7 @@
 #include "playable.h"
 #include "player.h"
 #include "prompt.h"
+#include "replay.h"
 #include "slot-select-mode.h"
 #include "species.h"
 #include "spl-util.h"
@@ -972,6 +973,8 @@ static string _get_save_path(string subdir)
 
 void game_options::reset_options()
 {
+    ++generation;
+
     // XXX: do we really need to rebuild the list and map every time?
     // Will they ever change within a single execution of Crawl?
     // GameOption::value's value will change of course, but not the reference.
@@ -1799,7 +1802,7 @@ void read_options(const string &s, bool runscript, bool clear_aliases)
 
 game_options::game_options()
     : seed(0), seed_from_rc(0),
-    no_save(false), language(lang_t::EN), lang_name(nullptr)
+    no_save(false), language(lang_t::EN), lang_name(nullptr), generation(0)
 {
     reset_options();
 }
@@ -2557,6 +2560,8 @@ void game_options::read_option_line(const string &str, bool runscript)
         key    = prequal;
     }
 
+    ++generation;
+
     // Clean up our data...
     lowercase(trim_string(key));
     lowercase(trim_string(subkey));
@@ -3877,7 +3882,15 @@ enum commandline_option_type
     CLO_OBJSTAT,
     CLO_ITERATIONS,
     CLO_FORCE_MAP,
+    CLO_VAULT_TEST,
     CLO_ARENA,
+    CLO_ARENA_BATCH,
+    CLO_FSIM,
+    CLO_WORKERS,
+    CLO_REPORT,
+    CLO_RECORD,
+    CLO_REPLAY,
+    CLO_PATTERN_BENCH,
     CLO_DUMP_MAPS,
     CLO_TEST,
     CLO_SCRIPT,
@@ -3917,12 +3930,13 @@ static const char *cmd_ops[] =
 {
     "scores", "name", "species", "background", "dir", "rc", "rcdir", "tscores",
     "vscores", "scorefile", "morgue", "macro", "mapstat", "dump-disconnect",
-    "objstat", "iters", "force-map", "arena", "dump-maps", "test", "script",
-    "builddb", "help", "version", "seed", "pregen", "save-version", "sprint",
-    "extra-opt-first", "extra-opt-last", "sprint-map", "edit-save",
-    "print-charset", "tutorial", "wizard", "explore", "no-save", "gdb",
-    "no-gdb", "nogdb", "throttle", "no-throttle", "playable-json",
-    "bones", "adventure",
+    "objstat", "iters", "force-map", "vault-test", "arena", "arena-batch",
+    "fsim", "workers", "report", "record", "replay", "pattern-bench", "dump-maps",
+    "test", "script", "builddb", "help", "version", "seed", "pregen",
+    "save-version", "sprint", "extra-opt-first", "extra-opt-last",
+    "sprint-map", "edit-save", "print-charset", "tutorial", "wizard",
+    "explore", "no-save", "gdb", "no-gdb", "nogdb", "throttle", "no-throttle",
+    "playable-json", "bones", "adventure",
 #ifdef USE_TILE_WEB
     "webtiles-socket", "await-connection", "print-webtiles-options",
 #endif
@@ -4815,6 +4829,25 @@ bool parse_args(int argc, char **argv, bool rc_only)
 #endif
             break;
 
+        case CLO_VAULT_TEST:
+#ifdef DEBUG_STATISTICS
+            crawl_state.map_stat_gen = true;
+            crawl_state.vault_test = true;
+#ifdef USE_TILE_LOCAL
+            crawl_state.tiles_disabled = true;
+#endif
+            if (!SysEnv.map_gen_iters)
+                SysEnv.map_gen_iters = 5;
+            if (next_is_param)
+            {
+                SysEnv.vault_test_maps = split_string(",", next_arg);
+                nextUsed = true;
+            }
+#else
+            end(1, false, "%s", dbg_stat_err);
+#endif
+            break;
+
         case CLO_ARENA:
             if (!rc_only)
             {
@@ -4829,6 +4862,72 @@ bool parse_args(int argc, char **argv, bool rc_only)
             }
             break;
 
+        case CLO_ARENA_BATCH:
+            if (!next_is_param || !isadigit(*next_arg))
+                end(1, false, "Integer argument required for -%s\n", arg);
+            if (!rc_only)
+            {
+                Options.game.type = GAME_TYPE_ARENA;
+                Options.restart_after_game = MB_FALSE;
+                SysEnv.arena_batch_rounds = max(1, atoi(next_arg));
+            }
+            nextUsed = true;
+            break;
+
+        case CLO_FSIM:
+#ifdef WIZARD
+            if (!next_is_param || strlen(next_arg) != 4)
+                end(1, false, "Species/background combo required for -%s\n",
+                    arg);
+            if (!rc_only)
+            {
+                SysEnv.fsim_combo = next_arg;
+                Options.restart_after_game = MB_FALSE;
+            }
+            nextUsed = true;
+#else
+            end(1, false, "-%s is available only in WIZARD builds.\n", arg);
+#endif
+            break;
+
+        case CLO_WORKERS:
+            if (!next_is_param || !isadigit(*next_arg))
+                end(1, false, "Integer argument required for -%s\n", arg);
+            SysEnv.workers = max(1, atoi(next_arg));
+            nextUsed = true;
+            break;
+
+        case CLO_REPORT:
+            if (!next_is_param)
+                end(1, false, "Filename argument required for -%s\n", arg);
+            SysEnv.report_file = next_arg;
+            nextUsed = true;
+            break;
+
+        case CLO_RECORD:
+            if (!next_is_param)
+                end(1, false, "Filename argument required for -%s\n", arg);
+            SysEnv.record_file = next_arg;
+            nextUsed = true;
+            break;
+
+        case CLO_REPLAY:
+            if (!next_is_param)
+                end(1, false, "Filename argument required for -%s\n", arg);
+            if (!rc_only)
+                replay_load(next_arg);
+            nextUsed = true;
+            break;
+
+        case CLO_PATTERN_BENCH:
+            if (!next_is_param)
+                end(1, false, "Filename argument required for -%s\n", arg);
+            nextUsed = true;
+            // Wait until the rc file has been read.
+            if (rc_only)
+                break;
+            end(bench_message_patterns(next_arg) ? 0 : 1);
+
         case CLO_DUMP_MAPS:
             crawl_state.dump_maps = true;
             break;
@@ -59,6 +59,14 @@ public:
 
     int map_gen_iters;
     unique_ptr<depth_ranges> map_gen_range;
+    vector<string> vault_test_maps; // Maps or .des files for -vault-test.
+
+    int arena_batch_rounds;        // Rounds to run in a headless arena batch.
+    string fsim_combo;             // Character for a headless fight sim batch.
+    int workers;                   // Processes to use for batch runs; 0 is
+                                   // one per CPU.
+    string report_file;            // Where batch runs write their results.
+    string record_file;            // Keystroke log to write (-record).
 
     vector<string> extra_opts_first;
     vector<string> extra_opts_last;
@@ -2166,6 +2166,7 @@ bool set_ident_type(object_class_type basetype, int subtype, bool identify)
 
     you.type_ids[basetype][subtype] = identify;
     request_autoinscribe();
+    invalidate_monster_info_cache();
 
     // Our item knowledge changed in a way that could possibly affect shop
     // prices.
@@ -3071,11 +3072,16 @@ bool is_interesting_item(const item_def& item)
         return true;
 
     const string iname = item_prefix(item, false) + " " + item.name(DESC_PLAIN);
-    for (const text_pattern &pat : Options.note_items)
-        if (pat.matches(iname))
-            return true;
+    static pattern_set note_patterns;
+    if (note_patterns.source != Options.generation)
+    {
+        note_patterns.clear();
+        for (const text_pattern &pat : Options.note_items)
+            note_patterns.add(pat);
+        note_patterns.source = Options.generation;
+    }
 
-    return false;
+    return note_patterns.first_match(iname) != -1;
 }
 
 /**
@@ -39,6 +39,7 @@
 #include "env.h"
 #include "evoke.h"
 #include "food.h"
+#include "free-slots.h"
 #include "god-passive.h"
 #include "god-prayer.h"
 #include "hints.h"
@@ -496,6 +497,9 @@ void init_item(int item)
     mitm[item].clear();
 }
 
+// Slots of mitm that were free when last looked at.
+static free_slot_list _free_items;
+
 // Returns an unused mitm slot, or NON_ITEM if none available.
 // The reserve is the number of item slots to not check.
 // Items may be culled if a reserve <= 10 is specified.
@@ -506,13 +510,10 @@ int get_mitm_slot(int reserve)
     if (crawl_state.game_is_arena())
         reserve = 0;
 
-    int item = NON_ITEM;
-
-    for (item = 0; item < (MAX_ITEMS - reserve); item++)
-        if (!mitm[item].defined())
-            break;
+    int item = _free_items.take(MAX_ITEMS, MAX_ITEMS - reserve,
+                                [](int i) { return !mitm[i].defined(); });
 
-    if (item >= MAX_ITEMS - reserve)
+    if (item == -1)
     {
         if (crawl_state.game_is_arena())
         {
@@ -693,6 +694,7 @@ void destroy_item(int dest, bool never_created)
 
     unlink_item(dest);
     destroy_item(mitm[dest], never_created);
+    _free_items.give_back(dest);
 }
 
 static void _handle_gone_item(const item_def &item)
@@ -3006,9 +3008,18 @@ static bool _is_option_autopickup(const item_def &item, bool ignore_force)
 #endif
 
     // Check for initial settings
-    for (const pair<text_pattern, bool>& option : Options.force_autopickup)
-        if (option.first.matches(iname))
-            return option.second;
+    static pattern_set force_patterns;
+    if (force_patterns.source != Options.generation)
+    {
+        force_patterns.clear();
+        for (const pair<text_pattern, bool>& option : Options.force_autopickup)
+            force_patterns.add(option.first);
+        force_patterns.source = Options.generation;
+    }
+
+    const int match = force_patterns.first_match(iname);
+    if (match != -1)
+        return Options.force_autopickup[match].second;
 
     return Options.autopickups[item.base_type];
 }
@@ -14,17 +14,23 @@
 #include "dungeon.h"
 #include "files.h"
 #include "god-wrath.h"
+#include "level-catchup.h"
 #include "los.h"
 #include "message.h"
 #include "mon-act.h"
 #include "mon-death.h"
 #include "mon-poly.h"
+#include "mon-util.h"
 #include "ng-setup.h"
+#include "pattern.h"
 #include "religion.h"
 #include "stairs.h"
+#include "stash.h"
 #include "state.h"
 #include "stringutil.h"
+#include "tilepick.h"
 #include "tileview.h"
+#include "tileweb.h"
 #include "view.h"
 #include "wiz-dgn.h"
 
@@ -430,6 +436,85 @@ LUAFN(debug_get_rng_state)
     return 1;
 }
 
+// Usage: tile_bench(iterations)
+// Times the tile lookups of redrawing the whole level <iterations> times and
+// returns the time per cell of each kind of lookup.
+LUAFN(debug_tile_bench)
+{
+    const int iterations = luaL_safe_checkint(ls, 1);
+    lua_pushstring(ls, tileidx_benchmark(max(iterations, 1)).c_str());
+    return 1;
+}
+
+// Usage: mon_class_bench(iterations)
+// Times the monster class data lookups of AI and LOS for every monster on the
+// level <iterations> times and returns the time per monster, through the
+// class table and through mondata.
+LUAFN(debug_mon_class_bench)
+{
+    const int iterations = luaL_safe_checkint(ls, 1);
+    lua_pushstring(ls, mons_class_benchmark(max(iterations, 1)).c_str());
+    return 1;
+}
+
+// Usage: catchup_bench(turns)
+// Catches the level up on <turns> turns of the player's absence, as coming
+// back to it would, and returns the time each pass took.
+LUAFN(debug_catchup_bench)
+{
+    const int turns = luaL_safe_checkint(ls, 1);
+    lua_pushstring(ls, level_catchup_benchmark(max(turns, 0)).c_str());
+    return 1;
+}
+
+#ifdef USE_TILE_WEB
+// Usage: webtiles_bench(iterations)
+// Times writing the full player and map messages <iterations> times and
+// returns the time and size of a frame.
+LUAFN(debug_webtiles_bench)
+{
+    const int iterations = luaL_safe_checkint(ls, 1);
+    lua_pushstring(ls, tiles.benchmark_frames(max(iterations, 1)).c_str());
+    return 1;
+}
+#endif
+
+// Usage: add_stash(x, y)
+// Has the stash tracker (re)examine the items at (x, y) on this level.
+LUAFN(debug_add_stash)
+{
+    COORDS(c, 1, 2);
+    StashTrack.add_stash(c);
+    return 0;
+}
+
+// Usage: stash_search(text)
+// Returns how many stash search results plain <text> gets on this level.
+LUAFN(debug_stash_search)
+{
+    PLUARET(number, StashTrack.count_matches_here(luaL_checkstring(ls, 1)));
+}
+
+// Usage: first_pattern_match(text, pattern, ...)
+// Returns which of the patterns first matches <text> (from 1, or 0 for none),
+// once through a pattern_set and once trying them one by one.
+LUAFN(debug_first_pattern_match)
+{
+    const string text = luaL_checkstring(ls, 1);
+    pattern_set set;
+    int serial = 0;
+    for (int i = 2; i <= lua_gettop(ls); ++i)
+    {
+        const text_pattern pattern(luaL_checkstring(ls, i));
+        set.add(pattern);
+        if (!serial && pattern.matches(text))
+            serial = i - 1;
+    }
+    lua_pushnumber(ls, set.first_match(text) + 1);
+    lua_pushnumber(ls, serial);
+    return 2;
+}
+
 const struct luaL_reg debug_dlib[] =
 {
 { "goto_place", debug_goto_place },
@@ -460,5 +545,14 @@ const struct luaL_reg debug_dlib[] =
 { "cpp_assert", debug_cpp_assert },
 { "reset_rng", debug_reset_rng },
 { "get_rng_state", debug_get_rng_state },
+{ "add_stash", debug_add_stash },
+{ "stash_search", debug_stash_search },
+{ "first_pattern_match", debug_first_pattern_match },
+{ "tile_bench", debug_tile_bench },
+{ "mon_class_bench", debug_mon_class_bench },
+{ "catchup_bench", debug_catchup_bench },
+#ifdef USE_TILE_WEB
+{ "webtiles_bench", debug_webtiles_bench },
+#endif
 { nullptr, nullptr }
 };
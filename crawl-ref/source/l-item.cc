@@ -1448,8 +1448,12 @@ static int l_item_get_items_at(lua_State *ls)
     coord_def s;
     s.x = luaL_safe_checkint(ls, 1);
     s.y = luaL_safe_checkint(ls, 2);
-    coord_def p = player2grid(s);
+    return lua_push_items_at(ls, player2grid(s));
+}
 
+int lua_push_items_at(lua_State *ls, const coord_def &p)
+{
+    // also used in l-view.cc
     if (!query_map_knowledge(false, p, [](const map_cell& cell) {
           return cell.item() && cell.item()->defined();
         }))
@@ -86,3 +86,4 @@ struct monster_info;
 void lua_push_moninf(lua_State *ls, monster_info *mi);
 
 int lua_push_shop_items_at(lua_State *ls, const coord_def &s);
+int lua_push_items_at(lua_State *ls, const coord_def &p);
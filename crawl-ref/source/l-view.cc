@@ -7,12 +7,15 @@
 
 #include "l-libs.h"
 
+#include "act-iter.h"
 #include "cloud.h"
 #include "cluautil.h"
 #include "coord.h"
+#include "coordit.h"
 #include "env.h"
 #include "l-defs.h"
 #include "mon-death.h"
+#include "mon-info.h"
 #include "player.h"
 #include "religion.h"
 #include "stringutil.h"
@@ -38,7 +41,7 @@ LUAFN(view_feature_at)
         lua_pushstring(ls, "unseen");
         return 1;
     }
-    dungeon_feature_type f = env.map_knowledge(p).feat();
+    dungeon_feature_type f = env.map_knowledge.get(p).feat();
     lua_pushstring(ls, dungeon_feature_name(f));
     return 1;
 }
@@ -57,7 +60,7 @@ LUAFN(view_cloud_at)
         lua_pushnil(ls);
         return 1;
     }
-    cloud_type c = env.map_knowledge(p).cloud();
+    cloud_type c = env.map_knowledge.get(p).cloud();
     if (c == CLOUD_NONE)
     {
         lua_pushnil(ls);
@@ -81,14 +84,14 @@ LUAFN(view_is_safe_square)
         PLUARET(boolean, false);
         return 1;
     }
-    cloud_type c = env.map_knowledge(p).cloud();
+    cloud_type c = env.map_knowledge.get(p).cloud();
     if (c != CLOUD_NONE
         && is_damaging_cloud(c, true, YOU_KILL(env.map_knowledge(p).cloudinfo()->killer)))
     {
         PLUARET(boolean, false);
         return 1;
     }
-    trap_type t = env.map_knowledge(p).trap();
+    trap_type t = env.map_knowledge.get(p).trap();
     if (t != TRAP_UNASSIGNED)
     {
         trap_def trap;
@@ -97,7 +100,7 @@ LUAFN(view_is_safe_square)
         PLUARET(boolean, trap.is_safe());
         return 1;
     }
-    dungeon_feature_type f = env.map_knowledge(p).feat();
+    dungeon_feature_type f = env.map_knowledge.get(p).feat();
     if (f != DNGN_UNSEEN && !feat_is_traversable_now(f) || feat_is_runed(f))
     {
         PLUARET(boolean, false);
@@ -154,7 +157,7 @@ LUAFN(view_withheld)
         PLUARET(boolean, false);
         return 1;
     }
-    PLUARET(boolean, env.map_knowledge(p).flags & MAP_WITHHELD);
+    PLUARET(boolean, env.map_knowledge.get(p).flags & MAP_WITHHELD);
     return 1;
 }
 
@@ -172,7 +175,7 @@ LUAFN(view_invisible_monster)
         PLUARET(boolean, false);
         return 1;
     }
-    PLUARET(boolean, env.map_knowledge(p).flags & MAP_INVISIBLE_MONSTER);
+    PLUARET(boolean, env.map_knowledge.get(p).flags & MAP_INVISIBLE_MONSTER);
     return 1;
 }
 
@@ -197,6 +200,113 @@ LUAFN(view_cell_see_cell)
     return 1;
 }
 
+// What a snapshot was taken of; it is reused until this changes.
+static string _snapshot_key()
+{
+    return make_stringf("%d %s %d,%d", you.num_turns,
+                        level_id::current().describe().c_str(),
+                        you.pos().x, you.pos().y);
+}
+
+static void _push_snapshot_cell(lua_State *ls, const coord_def &p)
+{
+    const coord_def s = grid2player(p);
+    const map_cell &cell = env.map_knowledge.get(p);
+    lua_newtable(ls);
+    lua_pushnumber(ls, s.x);
+    lua_setfield(ls, -2, "x");
+    lua_pushnumber(ls, s.y);
+    lua_setfield(ls, -2, "y");
+    lua_pushstring(ls, dungeon_feature_name(cell.feat()));
+    lua_setfield(ls, -2, "feature");
+    if (cell.cloud() != CLOUD_NONE)
+    {
+        lua_pushstring(ls, cloud_type_name(cell.cloud()).c_str());
+        lua_setfield(ls, -2, "cloud");
+    }
+}
+
+/*** Everything in view at once.
+ * For scripts that look over the whole view every turn: one call instead of
+ * a feature_at, cloud_at, monster.get_monster_at and items.get_items_at
+ * for every cell. The same table is handed out until the turn, the level
+ * or the player's position changes, so treat it as read-only.
+ * @treturn table with the fields `turn`; `cells`, an array of tables with
+ * `x`, `y`, `feature` and (if there is one) `cloud`; `monsters`, an array
+ * of @{monster-info} objects; and `items`, an array of tables with `x`, `y`
+ * and `items`, an array of @{Item} objects
+ * @function snapshot
+ */
+LUAFN(view_snapshot)
+{
+    const string key = _snapshot_key();
+
+    lua_getfield(ls, LUA_REGISTRYINDEX, "view_snapshot");
+    if (lua_istable(ls, -1))
+    {
+        lua_getfield(ls, -1, "key");
+        const bool current = lua_isstring(ls, -1)
+                             && key == lua_tostring(ls, -1);
+        lua_pop(ls, 1);
+        if (current)
+            return 1;
+    }
+    lua_pop(ls, 1);
+
+    lua_newtable(ls);
+    lua_pushstring(ls, key.c_str());
+    lua_setfield(ls, -2, "key");
+    lua_pushnumber(ls, you.num_turns);
+    lua_setfield(ls, -2, "turn");
+
+    lua_newtable(ls);
+    int ncells = 0;
+    lua_newtable(ls);
+    int nitems = 0;
+    for (visible_radius_iterator ri(you.pos(),
+                                    you.xray_vision ? LOS_NONE : LOS_DEFAULT);
+         ri; ++ri)
+    {
+        if (!you.see_cell(*ri))
+            continue;
+
+        _push_snapshot_cell(ls, *ri);
+        lua_rawseti(ls, -3, ++ncells);
+
+        if (!env.map_knowledge(*ri).item())
+            continue;
+        if (!lua_push_items_at(ls, *ri))
+            continue;
+        const coord_def s = grid2player(*ri);
+        lua_newtable(ls);
+        lua_pushnumber(ls, s.x);
+        lua_setfield(ls, -2, "x");
+        lua_pushnumber(ls, s.y);
+        lua_setfield(ls, -2, "y");
+        lua_insert(ls, -2);
+        lua_setfield(ls, -2, "items");
+        lua_rawseti(ls, -2, ++nitems);
+    }
+    lua_setfield(ls, -3, "items");
+    lua_setfield(ls, -2, "cells");
+
+    lua_newtable(ls);
+    int nmons = 0;
+    for (monster_near_iterator mi(&you); mi; ++mi)
+    {
+        if (!mi->visible_to(&you))
+            continue;
+        monster_info inf(*mi);
+        lua_push_moninf(ls, &inf);
+        lua_rawseti(ls, -2, ++nmons);
+    }
+    lua_setfield(ls, -2, "monsters");
+
+    lua_pushvalue(ls, -1);
+    lua_setfield(ls, LUA_REGISTRYINDEX, "view_snapshot");
+    return 1;
+}
+
 LUAFN(view_update_monsters)
 {
     ASSERT_DLUA;
@@ -214,6 +324,7 @@ static const struct luaL_reg view_lib[] =
     { "withheld", view_withheld },
     { "invisible_monster", view_invisible_monster },
     { "cell_see_cell", view_cell_see_cell },
+    { "snapshot", view_snapshot },
 
     { "update_monsters", view_update_monsters },
 
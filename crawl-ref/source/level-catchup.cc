@@ -0,0 +1,511 @@
+/**
+ * @file
+ * @brief Catch a level up on the time the player spent away from it.
+ *
+ * Nothing happens on a level while the player is elsewhere. When they come
+ * back, the time they were away is made up for in a few passes over the
+ * whole level, one kind of change at a time: clouds, terrain, monsters
+ * leaving, monsters recovering, monsters moving and monster enchantments
+ * running out. No pass simulates turn by turn, so the work depends on what
+ * is on the level and not on how long the player was gone.
+**/
+
+#include "AppHdr.h"
+
+#include "level-catchup.h"
+
+#include <chrono>
+
+#include "act-iter.h"
+#include "areas.h"
+#include "cloud.h"
+#include "coord.h"
+#include "dgn-event.h"
+#include "dgn-shoals.h"
+#include "env.h"
+#include "mon-behv.h"
+#include "mon-death.h"
+#include "mon-place.h"
+#include "mon-project.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "random.h"
+#include "rot.h"
+#include "state.h"
+#include "stringutil.h"
+#include "terrain.h"
+#include "timed-effects.h"
+#include "unwind.h"
+
+// The most squares a monster walks, however long the player was away.
+#define MAX_CATCHUP_MOVES 50
+
+struct level_catchup
+{
+    int elapsed;                // aut
+    int turns;
+    vector<monster*> monsters;  // the monsters that take part in catching up
+};
+
+/**
+ * Return the number of turns it takes for monsters to forget about the player
+ * 50% of the time.
+ *
+ * @param   The intelligence of the monster.
+ * @return  An average number of turns before the monster forgets.
+ */
+static int _mon_forgetfulness_time(mon_intel_type intelligence)
+{
+    switch (intelligence)
+    {
+        case I_HUMAN:
+            return 600;
+        case I_ANIMAL:
+            return 300;
+        case I_BRAINLESS:
+            return 150;
+        default:
+            die("Invalid intelligence type!");
+    }
+}
+
+/**
+ * Make monsters forget about the player after enough time passes off-level.
+ *
+ * @param mon           The monster in question.
+ * @param mon_turns     Monster turns. (Turns * monster speed)
+ * @return              Whether the monster forgot about the player.
+ */
+static bool _monster_forget(monster* mon, int mon_turns)
+{
+    // After x turns, half of the monsters will have forgotten about the
+    // player. A given monster has a 95% chance of forgetting the player after
+    // 4*x turns.
+    const int forgetfulness_time = _mon_forgetfulness_time(mons_intel(*mon));
+    const int forget_chances = mon_turns / forgetfulness_time;
+    // n.b. this is an integer division, so if range < forgetfulness_time
+    // nothing happens
+
+    if (bernoulli(forget_chances, 0.5))
+    {
+        mon->behaviour = BEH_WANDER;
+        mon->foe = MHITNOT;
+        mon->target = random_in_bounds();
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Make ranged monsters flee from the player during their time offlevel.
+ *
+ * @param mon           The monster in question.
+ */
+static void _monster_flee(monster *mon)
+{
+    mon->behaviour = BEH_FLEE;
+    dprf("backing off...");
+
+    if (mon->pos() != mon->target)
+        return;
+    // If the monster is on the target square, fleeing won't work.
+
+    if (in_bounds(env.old_player_pos) && env.old_player_pos != mon->pos())
+    {
+        // Flee from player's old position if different.
+        mon->target = env.old_player_pos;
+        return;
+    }
+
+    // Randomise the target so we have a direction to flee.
+    coord_def mshift;
+    mshift.x = random2(3) - 1;
+    mshift.y = random2(3) - 1;
+
+    // Bounds check: don't let fleeing monsters try to run off the grid.
+    const coord_def s = mon->target + mshift;
+    if (!in_bounds_x(s.x))
+        mshift.x = 0;
+    if (!in_bounds_y(s.y))
+        mshift.y = 0;
+
+    mon->target.x += mshift.x;
+    mon->target.y += mshift.y;
+
+    return;
+}
+
+/**
+ * Make a monster take a number of moves toward (or away from, if fleeing)
+ * their current target, very crudely.
+ *
+ * @param mon       The mon in question.
+ * @param moves     The number of moves to take.
+ */
+static void _catchup_monster_move(monster* mon, int moves)
+{
+    coord_def pos(mon->pos());
+
+    // Dirt simple movement.
+    for (int i = 0; i < moves; ++i)
+    {
+        coord_def inc(mon->target - pos);
+        inc = coord_def(sgn(inc.x), sgn(inc.y));
+
+        if (mons_is_retreating(*mon))
+            inc *= -1;
+
+        // Bounds check: don't let shifting monsters try to run off the
+        // grid.
+        const coord_def s = pos + inc;
+        if (!in_bounds_x(s.x))
+            inc.x = 0;
+        if (!in_bounds_y(s.y))
+            inc.y = 0;
+
+        if (inc.origin())
+            break;
+
+        const coord_def next(pos + inc);
+        const dungeon_feature_type feat = grd(next);
+        if (feat_is_solid(feat)
+            || monster_at(next)
+            || !monster_habitable_grid(mon, feat))
+        {
+            break;
+        }
+
+        pos = next;
+    }
+
+    if (!mon->shift(pos))
+        mon->shift(mon->pos());
+}
+
+/**
+ * Move monsters around to fake them walking around while player was
+ * off-level.
+ *
+ * Does not account for monster move speeds.
+ *
+ * Also make them forget about the player over time.
+ *
+ * @param mon       The monster under consideration
+ * @param turns     The number of offlevel player turns to simulate.
+ */
+static void _catchup_monster_moves(monster* mon, int turns)
+{
+    // Don't move non-land or stationary monsters around.
+    if (mons_primary_habitat(*mon) != HT_LAND
+        || mons_is_zombified(*mon)
+           && mons_class_primary_habitat(mon->base_monster) != HT_LAND
+        || mon->is_stationary())
+    {
+        return;
+    }
+
+    // Don't shift ballistomycete spores since that would disrupt their trail.
+    if (mon->type == MONS_BALLISTOMYCETE_SPORE)
+        return;
+
+    // special movement code for ioods
+    if (mons_is_projectile(*mon))
+    {
+        iood_catchup(mon, turns);
+        return;
+    }
+
+    // Let sleeping monsters lie.
+    if (mon->asleep() || mon->paralysed())
+        return;
+
+    const int mon_turns = (turns * mon->speed) / 10;
+    const int moves = min(mon_turns, MAX_CATCHUP_MOVES);
+
+    // probably too annoying even for DEBUG_DIAGNOSTICS
+    dprf("mon #%d: range %d; "
+         "pos (%d,%d); targ %d(%d,%d); flags %" PRIx64,
+         mon->mindex(), mon_turns, mon->pos().x, mon->pos().y,
+         mon->foe, mon->target.x, mon->target.y, mon->flags.flags);
+
+    if (mon_turns <= 0)
+        return;
+
+    // did the monster forget about the player?
+    const bool forgot = _monster_forget(mon, mon_turns);
+
+    // restore behaviour later if we start fleeing
+    unwind_var<beh_type> saved_beh(mon->behaviour);
+
+    if (!forgot && mons_has_ranged_attack(*mon))
+    {
+        // If we're doing short time movement and the monster has a
+        // ranged attack (missile or spell), then the monster will
+        // flee to gain distance if it's "too close", else it will
+        // just shift its position rather than charge the player. -- bwr
+        if (grid_distance(mon->pos(), mon->target) >= 3)
+        {
+            mon->shift(mon->pos());
+            dprf("shifted to (%d, %d)", mon->pos().x, mon->pos().y);
+            return;
+        }
+
+        _monster_flee(mon);
+    }
+
+    _catchup_monster_move(mon, moves);
+
+    dprf("moved to (%d, %d)", mon->pos().x, mon->pos().y);
+}
+
+/**
+ * Pacified monsters often leave the level while the player is away.
+ *
+ * @return Whether the monster left.
+ */
+static bool _catchup_pacified_leaves(monster &mon, int turns)
+{
+    if (mon.pacified() && turns > random2(40) + 21)
+    {
+        make_mons_leave_level(&mon);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Get rid of the player's summons, which don't outlast the player's
+ * absence.
+ *
+ * @return Whether the monster is done catching up: it is gone, or will be
+ *         as soon as it next acts.
+ */
+static bool _catchup_summon_expires(monster &mon, int turns)
+{
+    // Ball lightning dissapates harmlessly out of LOS
+    if (mon.type == MONS_BALL_LIGHTNING && mon.summoner == MID_PLAYER)
+    {
+        monster_die(mon, KILL_RESET, NON_MONSTER);
+        return true;
+    }
+
+    // Expire friendly summons
+    if (mon.friendly() && mon.is_summoned() && !mon.is_perm_summoned())
+    {
+        // You might still see them disappear if you were quick
+        if (turns > 2)
+            monster_die(mon, KILL_DISMISSED, NON_MONSTER);
+        else
+        {
+            mon_enchant abj  = mon.get_ench(ENCH_ABJ);
+            abj.duration = 0;
+            mon.update_ench(abj);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+static void _catchup_recovery(monster &mon, int turns)
+{
+    // XXX: Allow some spellcasting (like Healing and Teleport)? - bwr
+    // const bool healthy = (mon->hit_points * 2 > mon->max_hit_points);
+
+    mon.heal(div_rand_round(turns * mon.off_level_regen_rate(), 100));
+
+    // Handle nets specially to remove the trapping property of the net.
+    if (mon.caught())
+        mon.del_ench(ENCH_HELD, true);
+
+    mon.foe_memory = max(mon.foe_memory - turns, 0);
+}
+
+static void _catchup_enchantments(monster &mon, int turns)
+{
+    // FIXME:  Convert literal string 10 to constant to convert to auts
+    if (turns >= 10)
+        mon.timeout_enchantments(turns / 10);
+}
+
+/**
+ * Age the level's clouds. Level changes clear clouds anyway, so this only
+ * matters when time skips ahead on the player's own level (Step From Time).
+ */
+static void _catchup_clouds(level_catchup &lc)
+{
+    age_all_clouds(lc.elapsed);
+}
+
+static void _catchup_terrain(level_catchup &lc)
+{
+    rot_floor_items(lc.elapsed);
+    shoals_apply_tides(lc.turns, true, lc.turns < 5);
+    timeout_tombs(lc.turns);
+    timeout_terrain_changes(lc.elapsed);
+
+    if (env.sanctuary_time)
+    {
+        if (lc.turns >= env.sanctuary_time)
+            remove_sanctuary();
+        else
+            env.sanctuary_time -= lc.turns;
+    }
+
+    dungeon_events.fire_event(
+        dgn_event(DET_TURN_ELAPSED, coord_def(0, 0), lc.turns * 10));
+}
+
+/// Pick out the monsters that stay to catch up; the rest leave or vanish.
+static void _catchup_departures(level_catchup &lc)
+{
+    vector<monster*> all;
+    for (monster_iterator mi; mi; ++mi)
+        all.push_back(*mi);
+
+    lc.monsters.clear();
+    for (monster *mon : all)
+    {
+        // Monsters flagged to skip their next action are left alone.
+        if (!mon->alive()
+            || _catchup_pacified_leaves(*mon, lc.turns)
+            || mon->flags & MF_JUST_SUMMONED
+            || _catchup_summon_expires(*mon, lc.turns))
+        {
+            continue;
+        }
+        lc.monsters.push_back(mon);
+    }
+
+    dprf("%u of %u monsters catching up",
+         (unsigned int)lc.monsters.size(), (unsigned int)all.size());
+}
+
+static void _catchup_monster_recovery(level_catchup &lc)
+{
+    for (monster *mon : lc.monsters)
+        if (mon->alive())
+            _catchup_recovery(*mon, lc.turns);
+}
+
+static void _catchup_monster_movement(level_catchup &lc)
+{
+    for (monster *mon : lc.monsters)
+        if (mon->alive())
+            _catchup_monster_moves(mon, lc.turns);
+}
+
+static void _catchup_monster_enchantments(level_catchup &lc)
+{
+    for (monster *mon : lc.monsters)
+        if (mon->alive())
+            _catchup_enchantments(*mon, lc.turns);
+}
+
+struct catchup_pass
+{
+    const char *name;
+    void (*run)(level_catchup &lc);
+};
+
+// In order: terrain goes before monsters, since tombs and tides can move
+// them.
+static const catchup_pass catchup_passes[] =
+{
+    { "clouds",       _catchup_clouds },
+    { "terrain",      _catchup_terrain },
+    { "departures",   _catchup_departures },
+    { "recovery",     _catchup_monster_recovery },
+    { "movement",     _catchup_monster_movement },
+    { "enchantments", _catchup_monster_enchantments },
+};
+
+/**
+ * Update the level upon the player's return.
+ *
+ * @param elapsedTime how long the player was away.
+ */
+void update_level(int elapsedTime)
+{
+    ASSERT(!crawl_state.game_is_arena());
+
+    level_catchup lc;
+    lc.elapsed = elapsedTime;
+    lc.turns = elapsedTime / 10;
+
+    dprf("turns: %d", lc.turns);
+
+    for (const catchup_pass &pass : catchup_passes)
+        pass.run(lc);
+}
+
+/**
+ * Update the monster upon the player's return
+ *
+ * @param mon   The monster to update.
+ * @param turns How many turns (not auts) since the monster left the player
+ * @returns     Returns nullptr if monster was destroyed by the update;
+ *              Returns the updated monster if it still exists.
+ */
+monster* update_monster(monster& mon, int turns)
+{
+    if (_catchup_pacified_leaves(mon, turns))
+        return nullptr;
+
+    // Ignore monsters flagged to skip their next action
+    if (mon.flags & MF_JUST_SUMMONED || _catchup_summon_expires(mon, turns))
+        return &mon;
+
+    _catchup_recovery(mon, turns);
+    _catchup_monster_moves(&mon, turns);
+    if (mon.alive())
+        _catchup_enchantments(mon, turns);
+
+    return &mon;
+}
+
+static int _count_monsters()
+{
+    int count = 0;
+    for (monster_iterator mi; mi; ++mi)
+        ++count;
+    return count;
+}
+
+/**
+ * Time catching the level up on <turns> turns, pass by pass. This changes
+ * the level just as coming back to it would.
+ *
+ * @param turns How many turns the player was away.
+ * @return The time each pass took, and the monsters and clouds before and
+ *         after.
+ */
+string level_catchup_benchmark(int turns)
+{
+    level_catchup lc;
+    lc.elapsed = turns * 10;
+    lc.turns = turns;
+
+    const int monsters_before = _count_monsters();
+    const int clouds_before = env.cloud.size();
+
+    string result;
+    chrono::duration<double, micro> total(0);
+    for (const catchup_pass &pass : catchup_passes)
+    {
+        const auto start = chrono::steady_clock::now();
+        pass.run(lc);
+        const chrono::duration<double, micro> elapsed =
+            chrono::steady_clock::now() - start;
+        total += elapsed;
+        result += make_stringf("%-12s %8.1f us\n", pass.name, elapsed.count());
+    }
+
+    result += make_stringf("%-12s %8.1f us\n"
+                           "monsters %d -> %d, clouds %d -> %d\n",
+                           "total", total.count(),
+                           monsters_before, _count_monsters(),
+                           clouds_before, (int) env.cloud.size());
+    return result;
+}
@@ -0,0 +1,11 @@
+/**
+ * @file
+ * @brief Catch a level up on the time the player spent away from it.
+**/
+
+#pragma once
+
+void update_level(int elapsedTime);
+monster* update_monster(monster& mon, int turns);
+
+string level_catchup_benchmark(int turns);
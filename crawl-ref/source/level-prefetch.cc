@@ -0,0 +1,190 @@
+/**
+ * @file
+ * @brief Decompress the levels next to the current one in the background.
+ *
+ * While the player is idle at the command prompt, the saved chunks of the
+ * levels reachable by the known stairs of the current level, and of their
+ * sections, are read from the save (a cheap copy of their compressed bytes)
+ * and inflated on a worker thread. load_level() can then deserialise a level
+ * straight from memory. Each buffer remembers the version of the chunk it
+ * was made from, so a level that has been saved again since is never used
+ * stale.
+ *
+ * The worker only ever touches the entries it was handed; the main thread
+ * joins it before looking at or changing them, so no locking is needed.
+**/
+
+#include "AppHdr.h"
+
+#include "level-prefetch.h"
+
+#include "branch.h"
+#include "files.h"
+#include "package.h"
+#include "player.h"
+#include "tags.h"
+#include "threads.h"
+#include "travel.h"
+
+// How many levels to keep decompressed at once.
+#define MAX_PREFETCHED_LEVELS 8
+
+struct prefetch_entry
+{
+    string name;
+    uint32_t version;
+    vector<char> compressed;
+    vector<unsigned char> data;
+    bool ready;
+};
+
+static vector<prefetch_entry> entries;
+static level_id prefetched_for;
+static thread_t worker;
+static bool worker_running = false;
+
+static void *_inflate_entries(void *)
+{
+    for (prefetch_entry &entry : entries)
+    {
+        if (entry.ready)
+            continue;
+        entry.ready = inflate_chunk(entry.compressed, entry.data);
+        entry.compressed.clear();
+        if (!entry.ready)
+            entry.data.clear();
+    }
+    return nullptr;
+}
+
+static void _join_worker()
+{
+    if (!worker_running)
+        return;
+    thread_join(worker);
+    worker_running = false;
+}
+
+static bool _entry_current(const prefetch_entry &entry)
+{
+    return you.save && entry.version == you.save->chunk_version(entry.name);
+}
+
+static vector<level_id> _adjacent_levels()
+{
+    const level_id here = level_id::current();
+    vector<level_id> levels;
+    auto add = [&](const level_id &lid)
+    {
+        if (lid.is_valid() && lid != here
+            && find(levels.begin(), levels.end(), lid) == levels.end())
+        {
+            levels.push_back(lid);
+        }
+    };
+
+    add(find_up_level(here));
+    add(find_down_level(here));
+    if (LevelInfo *li = travel_cache.find_level_info(here))
+        for (const stair_info &si : li->get_stairs())
+            add(si.destination.id);
+
+    if (levels.size() > MAX_PREFETCHED_LEVELS)
+        levels.resize(MAX_PREFETCHED_LEVELS);
+    return levels;
+}
+
+/**
+ * Start decompressing the levels next to the current one, unless that has
+ * already been done for this level and none of them were saved since.
+ * Called when the game is waiting for a command; the decompression itself
+ * happens on another thread.
+ */
+void prefetch_adjacent_levels()
+{
+    if (!you.save
+        || prefetched_for == level_id::current()
+           && all_of(entries.begin(), entries.end(), _entry_current))
+    {
+        return;
+    }
+
+    _join_worker();
+
+    vector<string> chunks;
+    for (const level_id &lid : _adjacent_levels())
+    {
+        const string name = lid.describe();
+        if (!you.save->has_chunk(name))
+            continue;
+        chunks.push_back(name);
+        for (int i = 0; i < NUM_LEVEL_SECTIONS; ++i)
+        {
+            const string section = level_section_chunk(name, i);
+            if (you.save->has_chunk(section))
+                chunks.push_back(section);
+        }
+    }
+
+    vector<prefetch_entry> wanted;
+    for (const string &name : chunks)
+    {
+        auto old = find_if(entries.begin(), entries.end(),
+                           [&](const prefetch_entry &e)
+                           { return e.name == name; });
+        if (old != entries.end() && _entry_current(*old))
+        {
+            wanted.push_back(move(*old));
+            continue;
+        }
+
+        prefetch_entry entry;
+        entry.name = name;
+        entry.version = you.save->chunk_version(name);
+        entry.ready = false;
+        you.save->read_compressed(name, entry.compressed);
+        wanted.push_back(move(entry));
+    }
+    entries = move(wanted);
+    prefetched_for = level_id::current();
+
+    const bool work = any_of(entries.begin(), entries.end(),
+                             [](const prefetch_entry &e) { return !e.ready; });
+    if (work && !thread_create_joinable(&worker, _inflate_entries, nullptr))
+        worker_running = true;
+    else if (work)
+        entries.clear(); // couldn't start a thread; load levels as usual
+}
+
+/**
+ * Hand over a decompressed chunk of a level, if it has been prefetched
+ * from the chunk as it is now in the save.
+ *
+ * @param name The name of the level's chunk or of one of its sections.
+ * @param data Set to the decompressed chunk.
+ * @return Whether there was a usable prefetched copy.
+ */
+bool take_prefetched_level(const string &name, vector<unsigned char> &data)
+{
+    _join_worker();
+
+    auto entry = find_if(entries.begin(), entries.end(),
+                         [&](const prefetch_entry &e)
+                         { return e.name == name; });
+    if (entry == entries.end())
+        return false;
+
+    const bool usable = entry->ready && _entry_current(*entry);
+    if (usable)
+        data.swap(entry->data);
+    entries.erase(entry);
+    return usable;
+}
+
+/// Drop everything, e.g. because the save is about to go away.
+void level_prefetch_clear()
+{
+    _join_worker();
+    entries.clear();
+    prefetched_for = level_id();
+}
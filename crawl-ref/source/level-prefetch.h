@@ -0,0 +1,10 @@
+/**
+ * @file
+ * @brief Decompress the levels next to the current one in the background.
+**/
+
+#pragma once
+
+void prefetch_adjacent_levels();
+bool take_prefetched_level(const string &name, vector<unsigned char> &data);
+void level_prefetch_clear();
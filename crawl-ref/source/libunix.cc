@@ -34,6 +34,7 @@
 #include "colour.h"
 #include "cio.h"
 #include "crash.h"
+#include "replay.h"
 #include "state.h"
 #include "tiles-build-specific.h"
 #include "unicode.h"
@@ -530,6 +531,9 @@ void set_getch_returns_resizes(bool rr)
 
 int m_getch()
 {
+    if (replay_active())
+        return replay_next_key();
+
     int c;
     do
     {
@@ -566,6 +570,7 @@ int m_getch()
              ((c == CK_MOUSE_MOVE || c == CK_MOUSE_CLICK)
                  && !crawl_state.mouse_enabled));
 
+    replay_record_key(c);
     return c;
 }
 
@@ -1595,6 +1600,9 @@ void delay(unsigned int time)
 /* This is Juho Snellman's modified kbhit, to work with macros */
 bool kbhit()
 {
+    if (replay_fixed_input())
+        return false;
+
     if (pending)
         return true;
 
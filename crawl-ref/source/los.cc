@@ -53,6 +53,8 @@
 #include "env.h"
 #include "losglobal.h"
 #include "mon-act.h"
+#include "nearby-danger.h"
+#include "turn-profile.h"
 
 // These determine what rays are cast in the precomputation,
 // and affect start-up time significantly.
@@ -862,6 +864,9 @@ struct los_param_funcs : public los_param
 void losight(los_grid& sh, const coord_def& center,
              const opacity_func& opc, const circle_def& bounds)
 {
+    prof_timer timer(PROF_LOS);
+    prof_count(PROF_LOS_CALCS);
+
     const los_param& dat = los_param_funcs(center, opc, bounds);
 
     sh.init(false);
@@ -899,6 +904,7 @@ opacity_type mons_opacity(const monster* mon, los_type how)
 static void _handle_los_change()
 {
     invalidate_agrid();
+    invalidate_threat_set();
 }
 
 static bool _mons_block_sight(const monster* mons)
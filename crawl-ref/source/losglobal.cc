@@ -129,3 +129,42 @@ bool cell_see_cell(const coord_def& p, const coord_def& q, los_type l)
     ASSERT(*flags & (l << LOS_KNOWN));
     return *flags & l;
 }
+
+/**
+ * Look up which cells can be seen from p all at once: the same answers as
+ * calling cell_see_cell(p, p + d, l) for every offset d of the grid, but
+ * with the LOS of p brought up to date at most once.
+ *
+ * @param p       The viewpoint.
+ * @param l       The kind of LOS.
+ * @param visible Set to whether each cell around p is seen from it.
+ */
+void cell_see_cells(const coord_def& p, los_type l, los_grid &visible)
+{
+    if (l == LOS_NONE)
+    {
+        visible.init(true);
+        return;
+    }
+
+    visible.init(false);
+    bool updated = false;
+    for (int y = -LOS_MAX_RANGE; y <= LOS_MAX_RANGE; y++)
+        for (int x = -LOS_MAX_RANGE; x <= LOS_MAX_RANGE; x++)
+        {
+            const coord_def d(x, y);
+            losfield_t* flags = _lookup_globallos(p, p + d);
+            if (!flags)
+                continue;
+
+            if (!(*flags & (l << LOS_KNOWN)))
+            {
+                // One update fills in every cell in range of p.
+                ASSERT(!updated);
+                _update_globallos_at(p, l);
+                updated = true;
+            }
+            visible(d) = *flags & l;
+        }
+    UNUSED(updated);
+}
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "los.h"
 #include "los-type.h"
 
 void invalidate_los_around(const coord_def& p);
 void invalidate_los();
 
 bool cell_see_cell(const coord_def& p, const coord_def& q, los_type l);
+void cell_see_cells(const coord_def& p, los_type l, los_grid &visible);
@@ -85,6 +85,7 @@
 #include "items.h"
 #include "item-use.h"
 #include "jobs.h"
+#include "level-prefetch.h"
 #include "level-state-type.h"
 #include "libutil.h"
 #include "luaterp.h"
@@ -114,6 +115,7 @@
 #include "quiver.h"
 #include "random.h"
 #include "religion.h"
+#include "replay.h"
 #include "shopping.h"
 #include "shout.h"
 #include "skills.h"
@@ -140,6 +142,7 @@
 #include "transform.h"
 #include "traps.h"
 #include "travel.h"
+#include "turn-profile.h"
 #include "uncancel.h"
 #include "version.h"
 #include "viewchar.h"
@@ -330,6 +333,7 @@ static void _reset_game()
     crawl_state.reset_game();
     clear_message_store();
     macro_clear_buffers();
+    level_prefetch_clear();
     the_lost_ones.clear();
     shopping_list = ShoppingList();
     you = player();
@@ -389,6 +393,8 @@ static void _launch_game_loop()
 NORETURN static void _launch_game()
 {
     const bool game_start = startup_step();
+    if (game_start)
+        replay_game_started();
 
     // Attach the macro key recorder
     remove_key_recorder(&repeat_again_rec);
@@ -512,6 +518,21 @@ static void _show_commandline_options_help()
     puts("");
     puts("Arena options: (Stage a tournament between various monsters.)");
     puts("  -arena \"<monster list> v <monster list> arena:<arena map>\"");
+    puts("  -arena-batch <rounds> run the -arena fight <rounds> times without any");
+    puts("                        display, and report the aggregate results");
+    puts("  -workers <num>        number of processes for batch runs (default:");
+    puts("                        one per CPU)");
+    puts("  -report <file>        file for batch results; a .csv extension");
+    puts("                        selects CSV, anything else JSON");
+#ifdef WIZARD
+    puts("");
+    puts("Fight simulator options:");
+    puts("  -fsim <combo>         run the fight simulator without any display for");
+    puts("                        a new <combo> (e.g. MiFi) over every fsim_kit,");
+    puts("                        fsim_mons (comma-separated) and scale point,");
+    puts("                        and write the merged results to -report");
+    puts("                        (default fsim-batch.json)");
+#endif
 #ifdef DEBUG_DIAGNOSTICS
     puts("");
     puts("Diagnostic options:");
@@ -539,6 +560,11 @@ static void _show_commandline_options_help()
          "iterations");
     puts("  -force-map <map>    For -mapstat and -objstat, alway choose the "
          "      given map on every level.");
+    puts("  -vault-test [<maps>] build every level each map can be placed on,");
+    puts("      forcing that map, -iters times per level (default 5), over");
+    puts("      -workers processes; <maps> is a comma-separated list of map");
+    puts("      names or .des files (default: all). Writes placement failures,");
+    puts("      Lua errors and timings per map to vault-test.json or -report.");
 #endif
     puts("");
     puts("Miscellaneous options:");
@@ -547,6 +573,12 @@ static void _show_commandline_options_help()
     puts("  -gdb/-no-gdb     produce gdb backtrace when a crash happens (default:on)");
 #endif
     puts("  -playable-json   list playable species, jobs, and character combos.");
+    puts("  -record <file>   write the seed and keystrokes of a new game to <file>");
+    puts("  -replay <file>   replay a -record log without delays and write timings");
+    puts("                   to replay-bench.txt (or the file given by -report)");
+    puts("  -pattern-bench <file>");
+    puts("                   time the message and menu colour options of the rc");
+    puts("                   file against a log with one message per line");
 
 #if defined(TARGET_OS_WINDOWS) && defined(USE_TILE_LOCAL)
     text_popup(help, L"Dungeon Crawl command line help");
@@ -1071,7 +1103,8 @@ static void _input()
             update_can_train();
 
 #ifdef USE_TILE_WEB
-        tiles.flush_messages();
+        if (!rest_is_fast_forwarding())
+            tiles.flush_messages();
 #endif
 
         return;
@@ -1111,6 +1144,9 @@ static void _input()
         // Flush messages and display message window.
         msgwin_new_cmd();
 
+        if (!you.turn_is_over)
+            prefetch_adjacent_levels();
+
         crawl_state.waiting_for_command = true;
         c_input_reset(true);
 
@@ -2080,7 +2116,9 @@ static void _prep_input()
     you.shield_blocks = 0;              // no blocks this round
 
     you.redraw_status_lights = true;
-    print_stats();
+    // The redraw flags stay set until the rest is drawn again.
+    if (!rest_is_fast_forwarding())
+        print_stats();
 
     viewwindow();
     maybe_update_stashes();
@@ -2203,7 +2241,7 @@ static void _update_still_winds()
     end_still_winds();
 }
 
-void world_reacts()
+static void _world_reacts()
 {
     // All markers should be activated at this point.
     ASSERT(!env.markers.need_activate());
@@ -2332,6 +2370,15 @@ void world_reacts()
     you.los_noise_level = 0;
 }
 
+void world_reacts()
+{
+    {
+        prof_timer timer(PROF_WORLD_REACTS);
+        _world_reacts();
+    }
+    prof_end_turn();
+}
+
 static command_type _get_next_cmd()
 {
 #ifdef DGL_SIMPLE_MESSAGING
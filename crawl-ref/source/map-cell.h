@@ -60,63 +60,56 @@ struct cloud_info
 /*
  * A map_cell stores what the player knows about a cell.
  * These go in env.map_knowledge.
+ *
+ * Most cells know nothing beyond their terrain, so what is known about a
+ * cloud, item or monster there lives in a separately allocated block that
+ * only cells with any of those have. That keeps a plain cell at 16 bytes,
+ * which matters as there are several whole-level grids of these around.
  */
 struct map_cell
 {
     map_cell() : flags(0), _feat(DNGN_UNSEEN), _feat_colour(0),
-                 _trap(TRAP_UNASSIGNED), _cloud(0), _item(0), _mons(0)
+                 _trap(TRAP_UNASSIGNED), _contents(nullptr)
     {
     }
 
     map_cell(const map_cell& c)
+        : flags(c.flags), _feat(c._feat), _feat_colour(c._feat_colour),
+          _trap(c._trap),
+          _contents(c._contents ? new cell_contents(*c._contents) : nullptr)
     {
-        memcpy(this, &c, sizeof(map_cell));
-        if (_cloud)
-            _cloud = new cloud_info(*_cloud);
-        if (_mons)
-            _mons = new monster_info(*_mons);
-        if (_item)
-            _item = new item_info(*_item);
     }
 
     ~map_cell()
     {
-        if (_cloud)
-            delete _cloud;
-        if (!(flags & MAP_DETECTED_MONSTER) && _mons)
-            delete _mons;
-        if (_item)
-            delete _item;
+        delete _contents;
     }
 
     map_cell& operator=(const map_cell& c)
     {
         if (&c == this)
             return *this;
-        if (_cloud)
-            delete _cloud;
-        if (_mons)
-            delete _mons;
-        if (_item)
-            delete _item;
-        memcpy(this, &c, sizeof(map_cell));
-        if (_cloud)
-            _cloud = new cloud_info(*_cloud);
-        if (_mons)
-            _mons = new monster_info(*_mons);
-        if (_item)
-            _item = new item_info(*_item);
+        flags = c.flags;
+        _feat = c._feat;
+        _feat_colour = c._feat_colour;
+        _trap = c._trap;
+        delete _contents;
+        _contents = c._contents ? new cell_contents(*c._contents) : nullptr;
         return *this;
     }
 
+    // Cells that know of a cloud, item or monster never compare equal to
+    // another cell: they might be the same, but finding out isn't cheap.
     bool operator ==(const map_cell &other) const
     {
-        return memcmp(this, &other, sizeof(map_cell)) == 0;
+        return flags == other.flags && feat() == other.feat()
+               && _feat_colour == other._feat_colour
+               && _trap == other._trap && _contents == other._contents;
     }
 
     bool operator !=(const map_cell &other) const
     {
-        return memcmp(this, &other, sizeof(map_cell)) != 0;
+        return !(*this == other);
     }
 
     void clear()
@@ -156,14 +149,14 @@ struct map_cell
 
     item_info* item() const
     {
-        return _item;
+        return _contents ? _contents->item : nullptr;
     }
 
     bool detected_item() const
     {
         const bool ret = !!(flags & MAP_DETECTED_ITEM);
         // TODO: change to an ASSERT when the underlying crash goes away
-        if (ret && !_item)
+        if (ret && !item())
         {
             //clear_item();
             return false;
@@ -174,7 +167,7 @@ struct map_cell
     void set_item(const item_info& ii, bool more_items)
     {
         clear_item();
-        _item = new item_info(ii);
+        _add_contents().item = new item_info(ii);
         if (more_items)
             flags |= MAP_MORE_ITEMS;
     }
@@ -183,31 +176,32 @@ struct map_cell
 
     void clear_item()
     {
-        if (_item)
+        if (_contents && _contents->item)
         {
-            delete _item;
-            _item = 0;
+            delete _contents->item;
+            _contents->item = nullptr;
+            _prune_contents();
         }
         flags &= ~(MAP_DETECTED_ITEM | MAP_MORE_ITEMS);
     }
 
     monster_type monster() const
     {
-        if (_mons)
-            return _mons->type;
+        if (monster_info *mi = monsterinfo())
+            return mi->type;
         else
             return MONS_NO_MONSTER;
     }
 
     monster_info* monsterinfo() const
     {
-        return _mons;
+        return _contents ? _contents->mons : nullptr;
     }
 
     void set_monster(const monster_info& mi)
     {
         clear_monster();
-        _mons = new monster_info(mi);
+        _add_contents().mons = new monster_info(mi);
     }
 
     bool detected_monster() const
@@ -223,8 +217,9 @@ struct map_cell
     void set_detected_monster(monster_type mons)
     {
         clear_monster();
-        _mons = new monster_info(MONS_SENSED);
-        _mons->base_type = mons;
+        monster_info *mi = new monster_info(MONS_SENSED);
+        mi->base_type = mons;
+        _add_contents().mons = mi;
         flags |= MAP_DETECTED_MONSTER;
     }
 
@@ -236,46 +231,51 @@ struct map_cell
 
     void clear_monster()
     {
-        if (_mons)
-            delete _mons;
+        if (_contents && _contents->mons)
+        {
+            delete _contents->mons;
+            _contents->mons = nullptr;
+            _prune_contents();
+        }
         flags &= ~(MAP_DETECTED_MONSTER | MAP_INVISIBLE_MONSTER);
-        _mons = 0;
     }
 
     cloud_type cloud() const
     {
-        if (_cloud)
-            return _cloud->type;
+        if (cloud_info *ci = cloudinfo())
+            return ci->type;
         else
             return CLOUD_NONE;
     }
 
     unsigned cloud_colour() const
     {
-        if (_cloud)
-            return _cloud->colour;
+        if (cloud_info *ci = cloudinfo())
+            return ci->colour;
         else
             return 0;
     }
 
     cloud_info* cloudinfo() const
     {
-        return _cloud;
+        return _contents && _contents->has_cloud ? &_contents->cloud
+                                                 : nullptr;
     }
 
     void set_cloud(const cloud_info& ci)
     {
-        if (_cloud)
-            delete _cloud;
-        _cloud = new cloud_info(ci);
+        cell_contents &contents = _add_contents();
+        contents.cloud = ci;
+        contents.has_cloud = true;
     }
 
     void clear_cloud()
     {
-        if (_cloud)
+        if (_contents && _contents->has_cloud)
         {
-            delete _cloud;
-            _cloud = 0;
+            _contents->cloud = cloud_info();
+            _contents->has_cloud = false;
+            _prune_contents();
         }
     }
 
@@ -311,13 +311,61 @@ struct map_cell
         return _trap;
     }
 
+private:
+    // What is known about the cloud, item and monster in a cell.
+    struct cell_contents
+    {
+        cell_contents() : has_cloud(false), item(nullptr), mons(nullptr)
+        {
+        }
+
+        cell_contents(const cell_contents &c)
+            : cloud(c.cloud), has_cloud(c.has_cloud),
+              item(c.item ? new item_info(*c.item) : nullptr),
+              mons(c.mons ? new monster_info(*c.mons) : nullptr)
+        {
+        }
+
+        ~cell_contents()
+        {
+            delete item;
+            delete mons;
+        }
+
+        cell_contents& operator=(const cell_contents &c) = delete;
+
+        bool empty() const
+        {
+            return !has_cloud && !item && !mons;
+        }
+
+        cloud_info cloud;
+        bool has_cloud;
+        item_info* item;
+        monster_info* mons;
+    };
+
+    cell_contents& _add_contents()
+    {
+        if (!_contents)
+            _contents = new cell_contents;
+        return *_contents;
+    }
+
+    void _prune_contents()
+    {
+        if (_contents && _contents->empty())
+        {
+            delete _contents;
+            _contents = nullptr;
+        }
+    }
+
 public:
     uint32_t flags;   // Flags describing the mappedness of this square.
 private:
     dungeon_feature_type _feat:8;
     colour_t _feat_colour;
     trap_type _trap:8;
-    cloud_info* _cloud;
-    item_info* _item;
-    monster_info* _mons;
+    cell_contents* _contents;
 };
@@ -41,10 +41,10 @@ int count_detected_mons()
         // Note: assumptions are being made here about how
         // terrain can change (eg it used to be solid, and
         // thus monster/item free).
-        if (env.map_knowledge(*ri).changed())
+        if (env.map_knowledge.get(*ri).changed())
             continue;
 
-        if (env.map_knowledge(*ri).detected_monster())
+        if (env.map_knowledge.get(*ri).detected_monster())
             count++;
     }
 
@@ -117,7 +117,7 @@ void reautomap_level()
 
     for (int x = X_BOUND_1; x <= X_BOUND_2; ++x)
         for (int y = Y_BOUND_1; y <= Y_BOUND_2; ++y)
-            if (env.map_knowledge[x][y].flags & MAP_SEEN_FLAG)
+            if (env.map_knowledge.get(coord_def(x, y)).flags & MAP_SEEN_FLAG)
                 _automap_from(x, y, passive);
 }
 
@@ -172,9 +172,10 @@ void map_cell::set_detected_item()
 {
     clear_item();
     flags |= MAP_DETECTED_ITEM;
-    _item = new item_info();
-    _item->base_type = OBJ_DETECTED;
-    _item->rnd       = 1;
+    item_info *item = new item_info();
+    item->base_type = OBJ_DETECTED;
+    item->rnd       = 1;
+    _add_contents().item = item;
 }
 
 static bool _floor_mf(map_feature mf)
@@ -189,7 +190,7 @@ bool is_explore_horizon(const coord_def& c)
     if (player_in_branch(BRANCH_ABYSS))
         return false;
 
-    if (env.map_knowledge(c).feat() != DNGN_UNSEEN)
+    if (env.map_knowledge.get(c).feat() != DNGN_UNSEEN)
         return false;
 
     // Note: c might be on map edge, walkable squares not really.
@@ -288,7 +289,8 @@ void update_cloud_knowledge()
     {
         for (int y = Y_BOUND_1; y <= Y_BOUND_2; ++y)
         {
-            if (env.map_knowledge[x][y].update_cloud_state())
+            if (env.map_knowledge.get(coord_def(x, y)).cloudinfo()
+                && env.map_knowledge.cell(x, y).update_cloud_state())
             {
 #ifdef USE_TILE
                 tile_draw_map_cell({x, y}, true);
@@ -308,16 +310,17 @@ bool map_cell::update_cloud_state()
     if (visible())
         return false; // we're already up-to-date
 
+    const cloud_info *ci = cloudinfo();
+
     // player non-opaque clouds vanish instantly out of los
-    if (_cloud && _cloud->killer == KILL_YOU_MISSILE
-        && !is_opaque_cloud(_cloud->type))
+    if (ci && ci->killer == KILL_YOU_MISSILE && !is_opaque_cloud(ci->type))
     {
         clear_cloud();
         return true;
     }
 
     // still winds KOs all clouds, even those out of LOS
-    if (_cloud && env.level_state & LSTATE_STILL_WINDS)
+    if (ci && env.level_state & LSTATE_STILL_WINDS)
     {
         clear_cloud();
         return true;
@@ -334,7 +337,7 @@ std::pair<coord_def, coord_def> known_map_bounds() {
     for (int j = 0; j < GYM; j++)
         for (int i = 0; i < GXM; i++)
         {
-            if (env.map_knowledge[i][j].known())
+            if (env.map_knowledge.get(coord_def(i, j)).known())
             {
                 if (!found_y)
                 {
@@ -1628,4 +1628,17 @@ void mapstat_report_random_maps(FILE *outf, const level_id &place)
     _report_random_vaults(outf, place, false);
 }
 
+/**
+ * Load and resolve a copy of a map as placing it would, running its Lua,
+ * without putting it anywhere. Used by -vault-test for maps that have no
+ * DEPTH or PLACE to build a level for.
+ */
+bool mapstat_resolve_map(const map_def *vault)
+{
+    map_def &mdef = const_cast<map_def&>(*vault);
+    mdef.load();
+    map_def map = mdef;
+    return _resolve_map(map);
+}
+
 #endif //DEBUG_STATISTICS
@@ -92,4 +92,5 @@ private:
 
 #ifdef DEBUG_STATISTICS
 void mapstat_report_random_maps(FILE *outf, const level_id &place);
+bool mapstat_resolve_map(const map_def *vault);
 #endif
@@ -2297,16 +2297,22 @@ int menu_colour(const string &text, const string &prefix, const string &tag)
 {
     const string tmp_text = prefix + text;
 
-    for (const colour_mapping &cm : Options.menu_colour_mappings)
+    static pattern_set patterns;
+    if (patterns.source != Options.generation)
     {
-        if ((cm.tag.empty() || cm.tag == "any" || cm.tag == tag
-               || cm.tag == "inventory" && tag == "pickup")
-            && cm.pattern.matches(tmp_text))
-        {
-            return cm.colour;
-        }
+        patterns.clear();
+        for (const colour_mapping &cm : Options.menu_colour_mappings)
+            patterns.add(cm.pattern);
+        patterns.source = Options.generation;
     }
-    return -1;
+
+    const int match = patterns.first_match(tmp_text, [&](int i)
+        {
+            const string &cm_tag = Options.menu_colour_mappings[i].tag;
+            return cm_tag.empty() || cm_tag == "any" || cm_tag == tag
+                   || cm_tag == "inventory" && tag == "pickup";
+        });
+    return match == -1 ? -1 : Options.menu_colour_mappings[match].colour;
 }
 
 int MenuHighlighter::entry_colour(const MenuEntry *entry) const
@@ -7,6 +7,7 @@
 
 #include "message.h"
 
+#include <chrono>
 #include <sstream>
 
 #include "areas.h"
@@ -28,6 +29,7 @@
 #include "sound.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "tiles-build-specific.h"
 #include "unwind.h"
 #include "view.h"
@@ -1270,25 +1272,53 @@ void dprf(diag_type param, const char *format, ...)
 
 static bool _updating_view = false;
 
+// Rebuild the pattern_set of a message filter option if the options have
+// changed since it was made.
+static const pattern_set &_filter_patterns(pattern_set &patterns,
+                                           const vector<message_filter>& option)
+{
+    if (patterns.source != Options.generation)
+    {
+        patterns.clear();
+        for (const message_filter &filter : option)
+            patterns.add(filter.pattern, true);
+        patterns.source = Options.generation;
+    }
+    return patterns;
+}
+
+// The first filter of option that applies to the message, or -1.
+static int _filter_match(const string& line, msg_channel_type channel,
+                         const vector<message_filter>& option,
+                         pattern_set &patterns)
+{
+    return _filter_patterns(patterns, option).first_match(line,
+        [&](int i)
+        {
+            return option[i].channel == -1 || option[i].channel == channel;
+        });
+}
+
 static bool _check_option(const string& line, msg_channel_type channel,
-                          const vector<message_filter>& option)
+                          const vector<message_filter>& option,
+                          pattern_set &patterns)
 {
     if (crawl_state.generating_level)
         return false;
-    return any_of(begin(option),
-                  end(option),
-                  bind(mem_fn(&message_filter::is_filtered),
-                       placeholders::_1, channel, line));
+    return _filter_match(line, channel, option, patterns) != -1;
 }
 
 static bool _check_more(const string& line, msg_channel_type channel)
 {
-    return _check_option(line, channel, Options.force_more_message);
+    static pattern_set patterns;
+    return _check_option(line, channel, Options.force_more_message, patterns);
 }
 
 static bool _check_flash_screen(const string& line, msg_channel_type channel)
 {
-    return _check_option(line, channel, Options.flash_screen_message);
+    static pattern_set patterns;
+    return _check_option(line, channel, Options.flash_screen_message,
+                         patterns);
 }
 
 static bool _check_join(const string& line, msg_channel_type channel)
@@ -1647,21 +1677,23 @@ static void mpr_check_patterns(const string& message,
 {
     if (crawl_state.generating_level)
         return;
-    for (const text_pattern &pat : Options.note_messages)
+
+    static pattern_set note_patterns;
+    if (note_patterns.source != Options.generation)
     {
-        if (channel == MSGCH_EQUIPMENT || channel == MSGCH_FLOOR_ITEMS
-            || channel == MSGCH_MULTITURN_ACTION
-            || channel == MSGCH_EXAMINE || channel == MSGCH_EXAMINE_FILTER
-            || channel == MSGCH_TUTORIAL || channel == MSGCH_DGL_MESSAGE)
-        {
-            continue;
-        }
+        note_patterns.clear();
+        for (const text_pattern &pat : Options.note_messages)
+            note_patterns.add(pat);
+        note_patterns.source = Options.generation;
+    }
 
-        if (pat.matches(message))
-        {
-            take_note(Note(NOTE_MESSAGE, channel, param, message));
-            break;
-        }
+    if (channel != MSGCH_EQUIPMENT && channel != MSGCH_FLOOR_ITEMS
+        && channel != MSGCH_MULTITURN_ACTION
+        && channel != MSGCH_EXAMINE && channel != MSGCH_EXAMINE_FILTER
+        && channel != MSGCH_TUTORIAL && channel != MSGCH_DGL_MESSAGE
+        && note_patterns.first_match(message) != -1)
+    {
+        take_note(Note(NOTE_MESSAGE, channel, param, message));
     }
 
     if (channel != MSGCH_DIAGNOSTICS && channel != MSGCH_EQUIPMENT)
@@ -1703,14 +1735,21 @@ static msg_colour_type prepare_message(const string& imsg,
 
     if (!crawl_state.generating_level)
     {
-        for (const message_colour_mapping &mcm : Options.message_colour_mappings)
+        static pattern_set colour_patterns;
+        static vector<message_filter> colour_filters;
+        if (colour_patterns.source != Options.generation)
         {
-            if (mcm.message.is_filtered(channel, imsg))
+            colour_filters.clear();
+            for (const message_colour_mapping &mcm
+                 : Options.message_colour_mappings)
             {
-                colour = mcm.colour;
-                break;
+                colour_filters.push_back(mcm.message);
             }
         }
+        const int match = _filter_match(imsg, channel, colour_filters,
+                                        colour_patterns);
+        if (match != -1)
+            colour = Options.message_colour_mappings[match].colour;
     }
 
     return colour;
@@ -2207,3 +2246,128 @@ void formatted_mpr(const formatted_string& fs,
 {
     _mpr(fs.to_colour_string(), channel, param);
 }
+
+// The matching as it was done one pattern at a time, for the benchmark.
+static int _filter_match_serial(const string& line, msg_channel_type channel,
+                                const vector<message_filter>& option)
+{
+    for (int i = 0; i < (int) option.size(); ++i)
+        if (option[i].is_filtered(channel, line))
+            return i;
+    return -1;
+}
+
+static int _pattern_match_serial(const string& line,
+                                 const vector<text_pattern>& option)
+{
+    for (int i = 0; i < (int) option.size(); ++i)
+        if (option[i].matches(line))
+            return i;
+    return -1;
+}
+
+/**
+ * Time the message option lists (force_more_message, flash_screen_message,
+ * note_messages and message_colour) and menu_colour against each line of a
+ * message log, first one pattern at a time and then through pattern_sets,
+ * and check that both find the same first match. Used by -pattern-bench;
+ * the options are whatever the rc file set up.
+ *
+ * @param file A text file with one message per line.
+ * @return false if the two ways of matching disagreed.
+ */
+bool bench_message_patterns(const string &file)
+{
+    FILE *f = fopen_u(file.c_str(), "r");
+    if (!f)
+    {
+        fprintf(stderr, "Can't open message log %s\n", file.c_str());
+        return false;
+    }
+    vector<string> lines;
+    char buf[1024];
+    while (fgets(buf, sizeof buf, f))
+    {
+        string line = buf;
+        if (!line.empty() && line.back() == '\n')
+            line.pop_back();
+        lines.push_back(line);
+    }
+    fclose(f);
+
+    vector<message_filter> colour_filters;
+    for (const message_colour_mapping &mcm : Options.message_colour_mappings)
+        colour_filters.push_back(mcm.message);
+    vector<text_pattern> menu_patterns;
+    for (const colour_mapping &cm : Options.menu_colour_mappings)
+        menu_patterns.push_back(cm.pattern);
+
+    pattern_set more, flash, notes, colours, menu;
+    _filter_patterns(more, Options.force_more_message);
+    _filter_patterns(flash, Options.flash_screen_message);
+    _filter_patterns(colours, colour_filters);
+    for (const text_pattern &pat : Options.note_messages)
+        notes.add(pat);
+    for (const text_pattern &pat : menu_patterns)
+        menu.add(pat);
+
+    const msg_channel_type chan = MSGCH_PLAIN;
+    const int passes = 10;
+    typedef chrono::steady_clock clock;
+
+    auto run = [&](bool serial, vector<int> &results)
+    {
+        const clock::time_point start = clock::now();
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            results.clear();
+            for (const string &line : lines)
+            {
+                if (serial)
+                {
+                    results.push_back(_filter_match_serial(line, chan,
+                                          Options.force_more_message));
+                    results.push_back(_filter_match_serial(line, chan,
+                                          Options.flash_screen_message));
+                    results.push_back(_pattern_match_serial(line,
+                                          Options.note_messages));
+                    results.push_back(_filter_match_serial(line, chan,
+                                          colour_filters));
+                    results.push_back(_pattern_match_serial(line,
+                                          menu_patterns));
+                }
+                else
+                {
+                    results.push_back(_filter_match(line, chan,
+                                          Options.force_more_message, more));
+                    results.push_back(_filter_match(line, chan,
+                                          Options.flash_screen_message,
+                                          flash));
+                    results.push_back(notes.first_match(line));
+                    results.push_back(_filter_match(line, chan,
+                                                    colour_filters, colours));
+                    results.push_back(menu.first_match(line));
+                }
+            }
+        }
+        return chrono::duration_cast<chrono::duration<double>>(
+                   clock::now() - start).count();
+    };
+
+    vector<int> serial_results, set_results;
+    const double serial_secs = run(true, serial_results);
+    const double set_secs = run(false, set_results);
+    const bool same = serial_results == set_results;
+
+    const size_t patterns = more.size() + flash.size() + notes.size()
+                            + colours.size() + menu.size();
+    printf("%u messages, %u patterns, %d passes\n",
+           (unsigned int) lines.size(), (unsigned int) patterns, passes);
+    printf("one at a time: %.3f s\n", serial_secs);
+    printf("pattern sets:  %.3f s\n", set_secs);
+    if (set_secs > 0)
+        printf("speedup:       %.2fx\n", serial_secs / set_secs);
+    if (!same)
+        printf("MISMATCH: the two methods found different matches!\n");
+    return same;
+}
@@ -196,3 +196,5 @@ ostream& operator<<(ostream& os, const msg::setparam& sp);
 ostream& operator<<(ostream& os, const msg::capitalisation& cap);
 
 void set_msg_dump_file(FILE* file);
+
+bool bench_message_patterns(const string &file);
@@ -67,6 +67,7 @@
 #include "throw.h"
 #include "timed-effects.h"
 #include "traps.h"
+#include "turn-profile.h"
 #include "viewchar.h"
 #include "view.h"
 
@@ -1557,6 +1558,8 @@ static void _pre_monster_move(monster& mons)
 void handle_monster_move(monster* mons)
 {
     ASSERT(mons); // XXX: change to monster &mons
+    prof_timer timer(PROF_MONSTER_MOVE);
+    prof_count(PROF_MONSTER_MOVES);
     const monsterentry* entry = get_monster_data(mons->type);
     if (!entry)
         return;
@@ -2378,6 +2381,8 @@ static void _display_just_seen()
  */
 void handle_monsters(bool with_noise)
 {
+    prof_timer timer(PROF_HANDLE_MONSTERS);
+
     for (monster_iterator mi; mi; ++mi)
     {
         _pre_monster_move(**mi);
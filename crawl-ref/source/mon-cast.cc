@@ -13,6 +13,7 @@
 #include <unordered_set>
 
 #include "act-iter.h"
+#include "arena.h"
 #include "areas.h"
 #include "attack.h"
 #include "bloodspatter.h"
@@ -4379,6 +4380,7 @@ static void _mons_cast_spectral_orcs(monster* mons)
             {
                 orc->mname = mons_type_name(mon, DESC_PLAIN);
                 orc->flags |= MF_NAME_REPLACE | MF_NAME_DESCRIPTOR;
+                orc->info_changed();
             }
 
             // give gear using the base type
@@ -5646,6 +5648,9 @@ void mons_cast(monster* mons, bolt pbolt, spell_type spell_cast,
     // to do it again (cheap).
     setup_mons_cast(mons, pbolt, spell_cast);
 
+    if (crawl_state.game_is_arena())
+        arena_monster_cast(mons, spell_cast);
+
     // single calculation permissible {dlb}
     const unsigned int flags = get_spell_flags(spell_cast);
     actor* const foe = mons->get_foe();
@@ -7497,6 +7502,7 @@ static void _doom_howl(monster &mon)
          silenced(mon.pos()) ? "silent" : "terrible");
     you.duration[DUR_DOOM_HOWL] = random_range(120, 180);
     mon.props[DOOM_HOUND_HOWLED_KEY] = true;
+    mon.info_changed();
 }
 
 /**
@@ -19,6 +19,7 @@
 #include "mon-death.h"
 #include "mon-place.h"
 #include "mon-tentacle.h"
+#include "mon-util.h"
 #include "state.h"
 #include "stringutil.h"
 #include "terrain.h"
@@ -136,6 +137,8 @@ static void _init_player_illusion_properties(monsterentry *me)
     // available to them. :P
     if (form_changed_physiology() && me->holiness & MH_UNDEAD)
         me->holiness = MH_NATURAL;
+    // mons_class_holiness() reads the class table, not mondata.
+    mon_class_data.holiness[MONS_PLAYER_ILLUSION] = me->holiness;
 }
 
 
@@ -2923,6 +2923,7 @@ void monster_cleanup(monster* mons)
         you.pet_target = MHITNOT;
 
     mons->reset();
+    free_monster_slot(monster_killed);
 }
 
 item_def* mounted_kill(monster* daddy, monster_type mc, killer_type killer,
@@ -3391,6 +3392,7 @@ void elven_twin_died(monster* twin, bool in_transit, killer_type killer, int kil
 
         // Indicate that he has an updated spellbook.
         mons->props[CUSTOM_SPELLS_KEY] = true;
+        mons->info_changed();
     }
 
     // Finally give them new energy
@@ -3414,6 +3416,7 @@ void elven_twin_energize(monster* mons)
     }
 
     mons->props[ELVEN_IS_ENERGIZED_KEY] = true;
+    mons->info_changed();
 }
 
 /**
@@ -127,7 +127,12 @@ void monster::update_ench(const mon_enchant &ench)
     if (ench.ench != ENCH_NONE)
     {
         if (mon_enchant *curr_ench = map_find(enchantments, ench.ench))
+        {
+            // Durations tick down all the time and don't show.
+            if (curr_ench->degree != ench.degree)
+                info_changed();
             *curr_ench = ench;
+        }
     }
 }
 
@@ -165,6 +170,8 @@ bool monster::add_ench(const mon_enchant &ench)
             props[ORIGINAL_TYPE_KEY].get_int() = MONS_GLOWING_SHAPESHIFTER;
     }
 
+    info_changed();
+
     bool new_enchantment = false;
     mon_enchant *added = map_find(enchantments, ench.ench);
     if (added)
@@ -441,6 +448,7 @@ bool monster::del_ench(enchant_type ench, bool quiet, bool effect)
 
     enchantments.erase(et);
     ench_cache.set(et, false);
+    info_changed();
     if (effect)
         remove_enchantment_effect(me, quiet);
     return true;
@@ -425,7 +425,6 @@ monster_info::monster_info(const monster* m, int milev)
     attitude = mons_attitude(*m);
 
     type = m->type;
-    threat = mons_threat_level(*m);
 
     props.clear();
     // CrawlHashTable::begin() const can fail if the hash is empty.
@@ -436,13 +435,6 @@ monster_info::monster_info(const monster* m, int milev)
                 props[entry.first] = entry.second;
     }
 
-    // Translate references to tentacles into just their locations
-    if (mons_is_tentacle_or_tentacle_segment(type))
-    {
-        _translate_tentacle_ref(*this, m, "inwards");
-        _translate_tentacle_ref(*this, m, "outwards");
-    }
-
     base_type = m->base_monster;
     if (base_type == MONS_NO_MONSTER)
         base_type = type;
@@ -526,6 +518,7 @@ monster_info::monster_info(const monster* m, int milev)
 
     if (milev <= MILEV_NAME)
     {
+        update_relative(m, milev);
         if (type == MONS_DANCING_WEAPON
             && m->inv[MSLOT_WEAPON] != NON_ITEM)
         {
@@ -559,16 +552,6 @@ monster_info::monster_info(const monster* m, int milev)
         mb.set(MB_TWO_WEAPONS);
     if (!mons_can_regenerate(*m))
         mb.set(MB_NO_REGEN);
-    if (m->haloed() && !m->umbraed())
-        mb.set(MB_HALOED);
-    if (!m->haloed() && m->umbraed())
-        mb.set(MB_UMBRAED);
-    if (mons_looks_stabbable(*m))
-        mb.set(MB_STABBABLE);
-    if (mons_looks_distracted(*m))
-        mb.set(MB_DISTRACTED);
-    if (m->liquefied_ground())
-        mb.set(MB_SLOW_MOVEMENT);
     if (m->is_wall_clinging())
         mb.set(MB_CLINGING);
 
@@ -611,9 +594,6 @@ monster_info::monster_info(const monster* m, int milev)
     if (type == MONS_SILENT_SPECTRE)
         mb.set(MB_SILENCING);
 
-    if (you.beheld_by(*m))
-        mb.set(MB_MESMERIZING);
-
     if (testbits(m->flags, MF_ENSLAVED_SOUL))
         mb.set(MB_ENSLAVED);
 
@@ -695,6 +675,52 @@ monster_info::monster_info(const monster* m, int milev)
             inv[i].reset(new item_def(get_item_info(mitm[m->inv[i]])));
     }
 
+    if (m->props.exists("quote"))
+        quote = m->props["quote"].get_string();
+
+    if (m->props.exists("description"))
+        description = m->props["description"].get_string();
+
+    if (mons_has_ranged_attack(*m))
+        mb.set(MB_RANGED_ATTACK);
+
+    client_id = m->get_client_id();
+
+    // this must be last because it provides this structure to Lua code
+    update_relative(m, milev);
+}
+
+/**
+ * Recompute what this shows that depends on the player and the monster's
+ * surroundings rather than on the monster itself: threat, lines of fire,
+ * halos, stabbing, constriction, tentacle connections and safety.
+ *
+ * @param m     The monster this was made from.
+ * @param milev How much to find out, as for the constructor.
+ */
+void monster_info::update_relative(const monster* m, int milev)
+{
+    threat = mons_threat_level(*m);
+
+    // Translate references to tentacles into just their locations
+    if (mons_is_tentacle_or_tentacle_segment(type))
+    {
+        props.erase("inwards");
+        props.erase("outwards");
+        _translate_tentacle_ref(*this, m, "inwards");
+        _translate_tentacle_ref(*this, m, "outwards");
+    }
+
+    if (milev <= MILEV_NAME)
+        return;
+
+    mb.set(MB_HALOED, m->haloed() && !m->umbraed());
+    mb.set(MB_UMBRAED, !m->haloed() && m->umbraed());
+    mb.set(MB_STABBABLE, mons_looks_stabbable(*m));
+    mb.set(MB_DISTRACTED, mons_looks_distracted(*m));
+    mb.set(MB_SLOW_MOVEMENT, m->liquefied_ground());
+    mb.set(MB_MESMERIZING, you.beheld_by(*m));
+
     fire_blocker = DNGN_UNSEEN;
     if (!crawl_state.arena_suspended
         && m->pos() != you.pos())
@@ -702,12 +728,6 @@ monster_info::monster_info(const monster* m, int milev)
         _blocked_ray(m->pos(), &fire_blocker);
     }
 
-    if (m->props.exists("quote"))
-        quote = m->props["quote"].get_string();
-
-    if (m->props.exists("description"))
-        description = m->props["description"].get_string();
-
     // init names of constrictor and constrictees
     constrictor_name = "";
     constricting_name.clear();
@@ -742,10 +762,9 @@ monster_info::monster_info(const monster* m, int milev)
         }
     }
 
-    if (mons_has_ranged_attack(*m))
-        mb.set(MB_RANGED_ATTACK);
-
-    // this must be last because it provides this structure to Lua code
+    mb.set(MB_SAFE, false);
+    mb.set(MB_UNSAFE, false);
+    mb.set(MB_FIREWOOD, false);
     if (milev > MILEV_SKIP_SAFE)
     {
         if (mons_is_safe(m))
@@ -755,8 +774,6 @@ monster_info::monster_info(const monster* m, int milev)
         if (mons_is_firewood(*m))
             mb.set(MB_FIREWOOD);
     }
-
-    client_id = m->get_client_id();
 }
 
 /// Player-known max HP information for a monster: "about 55", "243".
@@ -1808,6 +1825,110 @@ bool monster_info::debuffable() const
                   { return this->has_trivial_ench(ench); });
 }
 
+// Bumped when something about the player changes what monster_info shows
+// of every monster, e.g. an item type being identified.
+static unsigned int info_epoch = 0;
+
+/**
+ * What a cached monster_info was made from. Besides the monster's
+ * info_version, which changes with its enchantments, equipment, position,
+ * hit points, name, god, spells, ghost and shown props, this has the fields
+ * that are cheap to compare and are changed directly all over the place.
+ * What depends on the player or the monster's surroundings is not part of
+ * the key: monster_info::update_relative() redoes it on every reuse.
+ */
+struct monster_info_key
+{
+    mid_t mid;
+    unsigned int version;
+    unsigned int epoch;
+    coord_def pos;
+    monster_type type;
+    monster_type base_monster;
+    unsigned int number;
+    int colour;
+    int hit_points;
+    int max_hit_points;
+    monster_flags_t flags;
+    mon_attitude_type attitude;
+    beh_type behaviour;
+    unsigned short foe;
+    size_t num_enchantments;
+    mid_t constricted_by;
+    uint32_t client_id;
+    uint32_t items;
+
+    monster_info_key(const monster &m)
+        : mid(m.mid), version(m.info_version), epoch(info_epoch),
+          pos(m.pos()), type(m.type),
+          base_monster(m.base_monster), number(m.number), colour(m.colour),
+          hit_points(m.hit_points), max_hit_points(m.max_hit_points),
+          flags(m.flags), attitude(m.attitude),
+          behaviour(m.behaviour), foe(m.foe),
+          num_enchantments(m.enchantments.size()),
+          constricted_by(m.constricted_by), client_id(m.client_id),
+          items(0)
+    {
+        // What the player knows of the items shows, too.
+        for (int i = 0; i < NUM_MONSTER_SLOTS; ++i)
+        {
+            items = items * 31 + m.inv[i];
+            if (m.inv[i] != NON_ITEM)
+                items = items * 31 + mitm[m.inv[i]].flags;
+        }
+    }
+
+    bool operator==(const monster_info_key &o) const
+    {
+        return mid == o.mid && version == o.version && epoch == o.epoch
+               && pos == o.pos && type == o.type
+               && base_monster == o.base_monster && number == o.number
+               && colour == o.colour && hit_points == o.hit_points
+               && max_hit_points == o.max_hit_points && flags == o.flags
+               && attitude == o.attitude && behaviour == o.behaviour
+               && foe == o.foe && num_enchantments == o.num_enchantments
+               && constricted_by == o.constricted_by
+               && client_id == o.client_id && items == o.items;
+    }
+};
+
+struct cached_monster_info
+{
+    monster_info_key key;
+    monster_info info;
+};
+
+static vector<unique_ptr<cached_monster_info>> info_cache(MAX_MONSTERS + 2);
+
+/**
+ * The monster_info (at MILEV_ALL) of a monster, reusing the one made last
+ * time if nothing about the monster has changed since. A reused one still
+ * has its player-relative parts brought up to date.
+ *
+ * @param m The monster.
+ * @return The info; it stays valid until the next call for this monster.
+ */
+const monster_info &get_cached_monster_info(const monster* m)
+{
+    ASSERT(m);
+    const int idx = m->mindex();
+    ASSERT_RANGE(idx, 0, (int) info_cache.size());
+
+    const monster_info_key key(*m);
+    unique_ptr<cached_monster_info> &entry = info_cache[idx];
+    if (!entry || !(entry->key == key))
+        entry.reset(new cached_monster_info { key, monster_info(m) });
+    else
+        entry->info.update_relative(m);
+    return entry->info;
+}
+
+/// Throw away every cached monster_info.
+void invalidate_monster_info_cache()
+{
+    ++info_epoch;
+}
+
 void get_monster_info(vector<monster_info>& mons)
 {
     vector<monster* > visible;
@@ -1824,7 +1945,7 @@ void get_monster_info(vector<monster_info>& mons)
         if (mons_is_threatening(*mon)
             || mon->is_child_tentacle())
         {
-            mons.emplace_back(mon);
+            mons.push_back(get_cached_monster_info(mon));
         }
     }
     sort(mons.begin(), mons.end(), monster_info::less_than_wrapper);
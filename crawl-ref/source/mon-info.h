@@ -242,6 +242,8 @@ struct monster_info : public monster_info_base
     explicit monster_info(monster_type p_type,
                           monster_type p_base_type = MONS_NO_MONSTER);
 
+    void update_relative(const monster* m, int milev = MILEV_ALL);
+
     monster_info(const monster_info& mi)
     : monster_info_base(mi), i_ghost(mi.i_ghost)
     {
@@ -386,5 +388,7 @@ bool set_monster_list_colour(string key, int colour);
 void clear_monster_list_colours();
 
 void get_monster_info(vector<monster_info>& mons);
+const monster_info &get_cached_monster_info(const monster* m);
+void invalidate_monster_info_cache();
 
 typedef function<vector<string> (const monster_info& mi)> (desc_filter);
@@ -12,6 +12,7 @@
 #include "state.h"
 #include "terrain.h"
 #include "traps.h"
+#include "turn-profile.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // monster_pathfind
@@ -131,6 +132,8 @@ bool monster_pathfind::init_pathfind(coord_def src, coord_def dest, bool diag,
 
 bool monster_pathfind::start_pathfind(bool msg)
 {
+    prof_count(PROF_MONSTER_PATHFINDS);
+
     // NOTE: We never do any traversable() check for the target square.
     //       This means that even if the target cannot be reached
     //       we may still find a path leading adjacent to this position, which
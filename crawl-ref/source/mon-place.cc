@@ -24,6 +24,7 @@
 #include "env.h"
 #include "errors.h"
 #include "fprop.h"
+#include "free-slots.h"
 #include "gender-type.h"
 #include "ghost.h"
 #include "god-abil.h"
@@ -823,16 +824,28 @@ monster* place_monster(mgen_data mg, bool force_pos, bool dont_place)
     return mon;
 }
 
+// Slots of menv that were free when last looked at.
+static free_slot_list _free_monsters;
+
 monster* get_free_monster()
 {
-    for (auto &mons : menv_real)
-        if (mons.type == MONS_NO_MONSTER)
-        {
-            mons.reset();
-            return &mons;
-        }
+    const int slot = _free_monsters.take(MAX_MONSTERS, MAX_MONSTERS,
+                                         [](int i)
+                                         {
+                                             return menv[i].type
+                                                    == MONS_NO_MONSTER;
+                                         });
+    if (slot == -1)
+        return nullptr;
 
-    return nullptr;
+    menv[slot].reset();
+    return &menv[slot];
+}
+
+/// A monster slot has just been freed; get_free_monster() hands it out next.
+void free_monster_slot(int mindex)
+{
+    _free_monsters.give_back(mindex);
 }
 
 void mons_add_blame(monster* mon, const string &blame_string)
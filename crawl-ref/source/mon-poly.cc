@@ -352,6 +352,7 @@ void change_monster_type(monster* mons, monster_type targetc)
 
     // Make sure we have a god if we've been polymorphed into a priest.
     mons->god = (mons->is_priest() && god == GOD_NO_GOD) ? GOD_NAMELESS : god;
+    mons->info_changed();
 
     mons->add_ench(abj);
     mons->add_ench(fabj);
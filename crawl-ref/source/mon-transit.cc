@@ -16,10 +16,10 @@
 #include "god-companions.h"
 #include "god-passive.h" // passive_t::convert_orcs
 #include "items.h"
+#include "level-catchup.h"
 #include "libutil.h" // map_find
 #include "mon-place.h"
 #include "religion.h"
-#include "timed-effects.h"
 
 #define MAX_LOST 100
 
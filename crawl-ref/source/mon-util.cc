@@ -8,6 +8,7 @@
 #include "mon-util.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <sstream>
 
@@ -69,6 +70,7 @@
 #include "unwind.h"
 
 static FixedVector < int, NUM_MONSTERS > mon_entry;
+monster_class_table mon_class_data;
 
 struct mon_display
 {
@@ -252,6 +254,17 @@ void init_monsters()
         if (entry == -1)
             entry = mon_entry[MONS_PROGRAM_BUG];
 
+    for (monster_type mc = MONS_0; mc < NUM_MONSTERS; ++mc)
+    {
+        const monsterentry &me = mondata[mon_entry[mc]];
+        mon_class_data.flags[mc]    = me.bitfields;
+        mon_class_data.species[mc]  = me.species;
+        mon_class_data.holiness[mc] = me.holiness;
+        mon_class_data.habitat[mc]  = me.habitat;
+        mon_class_data.size[mc]     = me.size;
+        mon_class_data.speed[mc]    = me.speed;
+    }
+
     init_monster_symbols();
 }
 
@@ -418,13 +431,6 @@ monster* monster_at(const coord_def &pos)
     return &menv[mindex];
 }
 
-/// Are any of the bits set?
-bool mons_class_flag(monster_type mc, monclass_flags_t bits)
-{
-    const monsterentry * const me = get_monster_data(mc);
-    return me && (me->bitfields & bits);
-}
-
 int monster::wearing(equipment_type slot, int sub_type, bool calc_unid) const
 {
     int ret = 0;
@@ -666,12 +672,6 @@ string holiness_description(mon_holy_type holiness)
     return description;
 }
 
-mon_holy_type mons_class_holiness(monster_type mc)
-{
-    ASSERT_smc();
-    return smc->holiness;
-}
-
 bool mons_class_is_stationary(monster_type mc)
 {
     return mons_class_flag(mc, M_STATIONARY);
@@ -1254,14 +1254,6 @@ bool mons_is_conjured(monster_type mc)
            || mons_class_flag(mc, M_CONJURED);
 }
 
-size_type mons_class_body_size(monster_type mc)
-{
-    // Should pass base_type to get the right size for zombies, skeletons &c.
-    // For normal monsters, base_type is set to type in the constructor.
-    const monsterentry *e = get_monster_data(mc);
-    return e ? e->size : SIZE_MEDIUM;
-}
-
 int max_corpse_chunks(monster_type mc)
 {
     switch (mons_class_body_size(mc))
@@ -1328,12 +1320,6 @@ monster_type mons_genus(monster_type mc)
     return smc->genus;
 }
 
-monster_type mons_species(monster_type mc)
-{
-    const monsterentry *me = get_monster_data(mc);
-    return me ? me->species : MONS_PROGRAM_BUG;
-}
-
 monster_type draco_or_demonspawn_subspecies(monster_type type,
                                             monster_type base)
 {
@@ -1815,6 +1801,8 @@ void name_zombie(monster& mon, monster_type mc, const string &mon_name)
     // we still want to allow it if overridden.
     if (!mon.props.exists("dbname"))
         mon.props["dbname"] = mons_class_name(mon.type);
+
+    mon.info_changed();
 }
 
 void name_zombie(monster& mon, const monster& orig)
@@ -3285,6 +3273,7 @@ bool give_monster_proper_name(monster& mon, bool orcs_only)
     mon.mname = _get_proper_monster_name(mon);
     if (!mon.props.exists("dbname"))
         mon.props["dbname"] = mons_class_name(mon.type);
+    mon.info_changed();
 
     if (mon.friendly())
         take_note(Note(NOTE_NAMED_ALLY, 0, 0, mon.mname));
@@ -3307,12 +3296,6 @@ static int _mons_exp_mod(monster_type mc)
     return smc->exp_mod;
 }
 
-int mons_class_base_speed(monster_type mc)
-{
-    ASSERT_smc();
-    return smc->speed;
-}
-
 mon_energy_usage mons_class_energy(monster_type mc)
 {
     ASSERT_smc();
@@ -3378,14 +3361,13 @@ mon_intel_type mons_intel(const monster& m)
 static habitat_type _mons_class_habitat(monster_type mc,
                                         bool real_amphibious = false)
 {
-    const monsterentry *me = get_monster_data(mc);
-    habitat_type ht = (me ? me->habitat
-                          : get_monster_data(MONS_PROGRAM_BUG)->habitat);
+    const monster_type entry = mons_class_in_range(mc) ? mc
+                                                       : MONS_PROGRAM_BUG;
+    habitat_type ht = mon_class_data.habitat[entry];
     if (!real_amphibious)
     {
         // XXX: No class equivalent of monster::body_size(PSIZE_BODY)!
-        size_type st = (me ? me->size
-                           : get_monster_data(MONS_PROGRAM_BUG)->size);
+        size_type st = mon_class_data.size[entry];
         if (ht == HT_LAND && st >= SIZE_GIANT || mc == MONS_GREY_DRACONIAN)
             ht = HT_AMPHIBIOUS;
     }
@@ -5611,6 +5593,8 @@ void init_mutant_beast(monster &mons, short HD, vector<int> beast_facets)
                 break;
         }
     }
+
+    mons.info_changed();
 }
 
 /**
@@ -5746,6 +5730,7 @@ void set_ancestor_spells(monster &ancestor, bool notify)
 
     if (ancestor.spells.size())
         ancestor.props[CUSTOM_SPELLS_KEY] = true;
+    ancestor.info_changed();
 
     if (!notify)
         return;
@@ -5787,3 +5772,70 @@ bool apply_visible_monsters(monster_func f, const coord_def& where, los_type los
 {
     return _apply_to_monsters(f, radius_iterator(where, los, true));
 }
+
+template <class F>
+static double _time_class_lookups(int iterations,
+                                  const vector<monster_type> &types,
+                                  unsigned int &sum, F lookup)
+{
+    const auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        for (monster_type mc : types)
+            sum += lookup(mc);
+    const chrono::duration<double, nano> elapsed =
+        chrono::steady_clock::now() - start;
+    return types.empty() ? 0 : elapsed.count() / iterations / types.size();
+}
+
+/**
+ * Time the class data lookups that monster AI, LOS and noise make for each
+ * monster on the level, once through the flat class table and once through
+ * mondata[], repeated some number of times.
+ *
+ * @param iterations How many times to go over the monsters.
+ * @return           One line per way of looking up, with the time per
+ *                   monster.
+ */
+string mons_class_benchmark(int iterations)
+{
+    vector<monster_type> types;
+    for (monster_iterator mi; mi; ++mi)
+        types.push_back(mi->type);
+    // An empty level still says something.
+    if (types.empty())
+        for (monster_type mc = MONS_0; mc < NUM_MONSTERS; ++mc)
+            types.push_back(mc);
+
+    unsigned int sum = 0;
+    const double table = _time_class_lookups(iterations, types, sum,
+        [](monster_type mc)
+        {
+            return mons_class_flag(mc, M_STATIONARY)
+                   + mons_class_flag(mc, M_NO_THREAT)
+                   + (mons_species(mc) == MONS_BUSH)
+                   + bool(mons_class_holiness(mc) & MH_UNDEAD)
+                   + mons_class_base_speed(mc)
+                   + mon_class_data.habitat[mc]
+                   + mons_class_body_size(mc);
+        });
+    const double entries = _time_class_lookups(iterations, types, sum,
+        [](monster_type mc)
+        {
+            const monsterentry *me = get_monster_data(mc);
+            return bool(me->bitfields & M_STATIONARY)
+                   + bool(me->bitfields & M_NO_THREAT)
+                   + (me->species == MONS_BUSH)
+                   + bool(me->holiness & MH_UNDEAD)
+                   + me->speed
+                   + me->habitat
+                   + me->size;
+        });
+
+    // The checksum keeps the lookups from being optimised away.
+    return make_stringf("%d monsters\n"
+                        "%-12s %8.1f ns/monster\n"
+                        "%-12s %8.1f ns/monster\n"
+                        "(checksum %u)\n",
+                        (int) types.size(), "class table", table,
+                        "mondata", entries, sum);
+}
@@ -187,6 +187,63 @@ static inline int get_resist(resists_t all, mon_resist_flags res)
     return v;
 }
 
+/**
+ * The class data that AI, LOS, noise and targeting ask about in their inner
+ * loops, one array per field so that a run of lookups of one field stays in
+ * a few cache lines. Indexed directly by monster type and filled in from
+ * mondata[] by init_monsters(); classes without an entry get the program
+ * bug's data, as get_monster_data() gives them. Code that changes one of
+ * these fields of a monsterentry later on (the player illusion's holiness)
+ * has to change the table too.
+ */
+struct monster_class_table
+{
+    alignas(64) monclass_flags_t flags[NUM_MONSTERS];
+    alignas(64) monster_type species[NUM_MONSTERS];
+    alignas(64) mon_holy_type holiness[NUM_MONSTERS];
+    alignas(64) habitat_type habitat[NUM_MONSTERS];
+    alignas(64) size_type size[NUM_MONSTERS];
+    alignas(64) int8_t speed[NUM_MONSTERS];
+};
+
+extern monster_class_table mon_class_data;
+
+static inline bool mons_class_in_range(monster_type mc)
+{
+    return mc >= 0 && mc < NUM_MONSTERS;
+}
+
+/// Are any of the bits set?
+static inline bool mons_class_flag(monster_type mc, monclass_flags_t bits)
+{
+    return mons_class_in_range(mc) && (mon_class_data.flags[mc] & bits);
+}
+
+static inline monster_type mons_species(monster_type mc)
+{
+    return mons_class_in_range(mc) ? mon_class_data.species[mc]
+                                   : MONS_PROGRAM_BUG;
+}
+
+static inline mon_holy_type mons_class_holiness(monster_type mc)
+{
+    ASSERT_RANGE(mc, 0, NUM_MONSTERS);
+    return mon_class_data.holiness[mc];
+}
+
+// Should pass base_type to get the right size for zombies, skeletons &c.
+// For normal monsters, base_type is set to type in the constructor.
+static inline size_type mons_class_body_size(monster_type mc)
+{
+    return mons_class_in_range(mc) ? mon_class_data.size[mc] : SIZE_MEDIUM;
+}
+
+static inline int mons_class_base_speed(monster_type mc)
+{
+    ASSERT_RANGE(mc, 0, NUM_MONSTERS);
+    return mon_class_data.speed[mc];
+}
+
 dungeon_feature_type habitat2grid(habitat_type ht);
 
 monsterentry *get_monster_data(monster_type mc) IMMUTABLE;
@@ -208,7 +265,6 @@ string mons_type_name(monster_type type, description_level_type desc);
 bool give_monster_proper_name(monster& mon, bool orcs_only = true);
 
 bool mons_flattens_trees(const monster& mon);
-size_type mons_class_body_size(monster_type mc);
 bool mons_class_res_tornado(monster_type mc);
 
 mon_itemuse_type mons_class_itemuse(monster_type mc);
@@ -252,12 +308,9 @@ bool flavour_has_reach(attack_flavour flavour);
 
 corpse_effect_type mons_corpse_effect(monster_type mc);
 
-bool mons_class_flag(monster_type mc, monclass_flags_t bits);
-
 mon_holy_type holiness_by_name(string name);
 const char * holiness_name(mon_holy_type_flags which_holiness);
 string holiness_description(mon_holy_type holiness);
-mon_holy_type mons_class_holiness(monster_type mc);
 
 void discover_mimic(const coord_def& pos);
 void discover_shifter(monster& shifter);
@@ -293,7 +346,6 @@ bool mons_skeleton(monster_type mc);
 bool mons_zombifiable(monster_type mc);
 
 int max_corpse_chunks(monster_type mc);
-int mons_class_base_speed(monster_type mc);
 mon_energy_usage mons_class_energy(monster_type mc);
 mon_energy_usage mons_energy(const monster& mon);
 int mons_class_zombie_base_speed(monster_type zombie_base_mc);
@@ -382,7 +434,6 @@ bool mons_is_plant(const monster& mon);
 bool mons_eats_items(const monster& mon);
 bool actor_is_susceptible_to_vampirism(const actor& act);
 monster_type mons_genus(monster_type mc);
-monster_type mons_species(monster_type mc);
 monster_type draco_or_demonspawn_subspecies(const monster& mon);
 monster_type draco_or_demonspawn_subspecies(monster_type type,
                                             monster_type base);
@@ -579,3 +630,4 @@ bool apply_visible_monsters(monster_func mf,
                             los_type los = LOS_NO_TRANS);
 
 int derived_undead_avg_hp(monster_type mtype, int hd, int scale = 10);
+string mons_class_benchmark(int iterations);
@@ -78,7 +78,7 @@ monster::monster()
       enchantments(), flags(), xp_tracking(XP_NON_VAULT), experience(0),
       base_monster(MONS_NO_MONSTER), number(0), colour(COLOUR_INHERIT),
       foe_memory(0), god(GOD_NO_GOD), ghost(), seen_context(SC_NONE),
-      client_id(0), hit_dice(0)
+      client_id(0), info_version(0), hit_dice(0)
 
 {
     type = MONS_NO_MONSTER;
@@ -101,6 +101,7 @@ monster::~monster()
 }
 
 monster::monster(const monster& mon)
+    : info_version(0)
 {
     constricting = 0;
     init_with(mon);
@@ -159,6 +160,7 @@ void monster::reset()
     ASSERT(!constricting);
 
     client_id = 0;
+    info_changed();
 
     // Just for completeness.
     speed           = 0;
@@ -1028,6 +1030,8 @@ bool monster::unequip(item_def &item, bool msg, bool force)
     if (!force && item.cursed())
         return false;
 
+    info_changed();
+
     if (!force && you.can_see(*this))
         set_ident_flags(item, ISFLAG_KNOW_CURSE);
 
@@ -1081,6 +1085,8 @@ bool monster::pickup(item_def &item, mon_inv_type slot, bool msg)
 {
     ASSERT(item.defined());
 
+    info_changed();
+
     const monster* other_mon = item.holding_monster();
 
     if (other_mon != nullptr)
@@ -1199,6 +1205,8 @@ bool monster::drop_item(mon_inv_type eslot, bool msg)
     if (item_index == NON_ITEM)
         return true;
 
+    info_changed();
+
     item_def& pitem = mitm[item_index];
 
     // Unequip equipped items before dropping them; unequip() prevents
@@ -2676,6 +2684,7 @@ int monster::mindex() const
 void monster::set_hit_dice(int new_hit_dice)
 {
     hit_dice = new_hit_dice;
+    info_changed();
 
     // XXX: this is unbelievably hacky to preserve old behaviour
     if (type == MONS_OKLOB_PLANT && !spells.empty()
@@ -2698,6 +2707,7 @@ void monster::moveto(const coord_def& c, bool clear_net)
     }
 
     set_position(c);
+    info_changed();
 
     // Do constriction invalidation after to the move, so that all LOS checking
     // is available.
@@ -3488,6 +3498,7 @@ bool monster::heal(int amount)
         return false;
 
     hit_points += amount;
+    info_changed();
 
     bool success = true;
 
@@ -4460,6 +4471,7 @@ int monster::hurt(const actor *agent, int amount, beam_type flavour,
 
         amount = min(amount, hit_points);
         hit_points -= amount;
+        info_changed();
 
         if (hit_points > max_hit_points)
         {
@@ -4577,6 +4589,7 @@ void monster::slow_down(actor *atk, int strength)
 void monster::set_ghost(const ghost_demon &g)
 {
     ghost.reset(new ghost_demon(g));
+    info_changed();
 
     if (!ghost->name.empty())
         mname = ghost->name;
@@ -4638,6 +4651,7 @@ void monster::uglything_init(bool only_mutate)
     speed           = ghost->speed;
     speed_increment = 70;
     colour          = ghost->colour;
+    info_changed();
 }
 
 void monster::ghost_demon_init()
@@ -4651,6 +4665,7 @@ void monster::ghost_demon_init()
         colour = ghost->colour;
 
     load_ghost_spells();
+    info_changed();
 }
 
 void monster::uglything_mutate(colour_t force_colour)
@@ -5319,6 +5334,7 @@ bool monster::malmutate(const string &/*reason*/)
     {
 #ifdef USE_TILE
         props[TILE_NUM_KEY].get_short() = ui_random(256);
+        info_changed();
 #endif
         return true;
     }
@@ -6683,6 +6699,7 @@ void monster::note_spell_cast(spell_type spell)
     dprf("tracking seen spell %s for %s",
          spell_title(spell), name(DESC_A, true).c_str());
     props[SEEN_SPELLS_KEY].get_vector().push_back(spell);
+    info_changed();
 }
 
 /**
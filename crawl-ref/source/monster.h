@@ -111,6 +111,8 @@ public:
     uint32_t client_id;                // for ID of monster_info between turns
     static uint32_t last_client_id;
 
+    unsigned int info_version;         // bumped by info_changed()
+
     bool went_unseen_this_turn;
     coord_def unseen_pos;
 
@@ -121,6 +123,8 @@ public:
     void reset_client_id();
     void ensure_has_client_id();
 
+    void info_changed() { ++info_version; }
+
     void set_hit_dice(int new_hd);
 
     mon_attitude_type temp_attitude() const override;
@@ -33,6 +33,67 @@
 #include "traps.h"
 #include "travel.h"
 
+/**
+ * What the safety checks have found out this turn.
+ *
+ * The run and rest delays, the monster list, interrupts and travel all ask
+ * whether the player is safe, several times a turn, and each answer may
+ * take a sweep of the player's LOS, pathfinding per monster and a call to
+ * the ch_mon_is_safe Lua hook. The answers are kept until the turn, the
+ * player's position or the level change, or until invalidate_threat_set()
+ * is called because something moved, changed sides or changed what can be
+ * seen (any LOS change, such as a door closing or a wall being dug).
+ */
+struct threat_set
+{
+    bool valid = false;
+    int turn;
+    int elapsed_time;
+    coord_def pos;
+    level_id place;
+    int range;
+    bool xray;
+
+    // The monsters in the player's LOS at the time, in sweep order.
+    vector<pair<monster*, mid_t>> in_view;
+    bool in_view_done;
+
+    // mons_is_safe() answers, by monster and the flags that change them.
+    map<pair<mid_t, int>, bool> safe;
+
+    void update()
+    {
+        if (valid
+            && turn == you.num_turns
+            && elapsed_time == you.elapsed_time
+            && pos == you.pos()
+            && place == level_id::current()
+            && range == you.current_vision
+            && xray == you.xray_vision)
+        {
+            return;
+        }
+
+        valid = true;
+        turn = you.num_turns;
+        elapsed_time = you.elapsed_time;
+        pos = you.pos();
+        place = level_id::current();
+        range = you.current_vision;
+        xray = you.xray_vision;
+        in_view.clear();
+        in_view_done = false;
+        safe.clear();
+    }
+};
+
+static threat_set threats;
+
+/// Forget what the safety checks found out this turn.
+void invalidate_threat_set()
+{
+    threats.valid = false;
+}
 
 // HACK ALERT: In the following several functions, want_move is true if the
 // player is travelling. If that is the case, things must be considered one
@@ -126,8 +187,9 @@ static bool _mons_is_always_safe(const monster *mon)
                && !mons_is_active_ballisto(*mon));
 }
 
-bool mons_is_safe(const monster* mon, const bool want_move,
-                  const bool consider_user_options, bool check_dist)
+static bool _mons_is_safe(const monster* mon, const bool want_move,
+                          const bool consider_user_options, bool check_dist,
+                          bool moving)
 {
     // Short-circuit plants, some vaults have tons of those. Except for both
     // active and inactive ballistos, players may still want these.
@@ -148,12 +210,6 @@ bool mons_is_safe(const monster* mon, const bool want_move,
 #ifdef CLUA_BINDINGS
     if (consider_user_options)
     {
-        bool moving = you_are_delayed()
-                       && current_delay()->is_run()
-                       && current_delay()->is_resting()
-                      || you.running < RMODE_NOT_RUNNING
-                      || want_move;
-
         bool result = is_safe;
 
         monster_info mi(mon, MILEV_SKIP_SAFE);
@@ -164,11 +220,54 @@ bool mons_is_safe(const monster* mon, const bool want_move,
             is_safe = result;
         }
     }
+#else
+    UNUSED(moving);
 #endif
 
     return is_safe;
 }
 
+bool mons_is_safe(const monster* mon, const bool want_move,
+                  const bool consider_user_options, bool check_dist)
+{
+    const bool moving = you_are_delayed()
+                         && current_delay()->is_run()
+                         && current_delay()->is_resting()
+                        || you.running < RMODE_NOT_RUNNING
+                        || want_move;
+
+    threats.update();
+    const int flags = want_move | consider_user_options << 1
+                      | check_dist << 2 | moving << 3;
+    const auto key = make_pair(mon->mid, flags);
+    if (bool *safe = map_find(threats.safe, key))
+        return *safe;
+
+    const bool safe = _mons_is_safe(mon, want_move, consider_user_options,
+                                    check_dist, moving);
+    threats.safe[key] = safe;
+    return safe;
+}
+
+// The monsters in LOS within the player's vision, as a sweep of it finds
+// them.
+static const vector<pair<monster*, mid_t>> &_monsters_in_view()
+{
+    threats.update();
+    if (threats.in_view_done)
+        return threats.in_view;
+
+    for (visible_radius_iterator ri(you.pos(), threats.range, C_SQUARE,
+                                    threats.xray ? LOS_NONE : LOS_DEFAULT);
+         ri; ++ri)
+    {
+        if (monster* mon = monster_at(*ri))
+            threats.in_view.emplace_back(mon, mon->mid);
+    }
+    threats.in_view_done = true;
+    return threats.in_view;
+}
+
 // Return all nearby monsters in range (default: LOS) that the player
 // is able to recognise as being monsters (i.e. no submerged creatures.)
 //
@@ -192,23 +291,43 @@ vector<monster* > get_nearby_monsters(bool want_move,
         range = you.current_vision;
 
     vector<monster* > mons;
-
-    // Sweep every visible square within range.
-    for (radius_iterator ri(you.pos(), range, C_SQUARE, you.xray_vision ? LOS_NONE : LOS_DEFAULT); ri; ++ri)
+    auto check = [&](monster* mon)
     {
-        if (monster* mon = monster_at(*ri))
+        if (mon->alive()
+            && (!require_visible || mon->visible_to(&you))
+            && !mon->submerged()
+            && (!dangerous_only || !mons_is_safe(mon, want_move,
+                                                 consider_user_options,
+                                                 check_dist)))
         {
-            if (mon->alive()
-                && (!require_visible || mon->visible_to(&you))
-                && !mon->submerged()
-                && (!dangerous_only || !mons_is_safe(mon, want_move,
-                                                     consider_user_options,
-                                                     check_dist)))
-            {
-                mons.push_back(mon);
-                if (just_check) // stop once you find one
+            mons.push_back(mon);
+            return true;
+        }
+        return false;
+    };
+
+    if (range > you.current_vision)
+    {
+        // Sweep every visible square within range.
+        for (visible_radius_iterator ri(you.pos(), range, C_SQUARE, you.xray_vision ? LOS_NONE : LOS_DEFAULT); ri; ++ri)
+            if (monster* mon = monster_at(*ri))
+                if (check(mon) && just_check) // stop once you find one
                     break;
-            }
+        return mons;
+    }
+
+    // Squares within a smaller range come up in the same order in the
+    // sweep of the whole of the player's vision. The list is copied, as a
+    // Lua safety hook might invalidate the threat set while we go over it.
+    const vector<pair<monster*, mid_t>> in_view = _monsters_in_view();
+    for (const auto &seen : in_view)
+    {
+        monster* mon = seen.first;
+        if (mon->mid == seen.second
+            && grid_distance(you.pos(), mon->pos()) <= range
+            && check(mon) && just_check) // stop once you find one
+        {
+            break;
         }
     }
     return mons;
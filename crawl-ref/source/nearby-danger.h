@@ -39,6 +39,8 @@ bool player_in_a_dangerous_place(bool *invis = nullptr);
 void bring_to_safety();
 void revive(); // XXX: move elsewhere?
 
+void invalidate_threat_set();
+
 #define DISCONNECT_DIST (INT_MAX - 1000)
 
 struct position_node
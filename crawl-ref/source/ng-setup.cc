@@ -23,6 +23,7 @@
 #include "options.h"
 #include "prompt.h"
 #include "religion.h"
+#include "replay.h"
 #include "tiledef-player.h"
 #if TAG_MAJOR_VERSION == 34
 # include "shopping.h" // REMOVED_DEAD_SHOPS_KEY
@@ -514,6 +515,8 @@ static void _setup_generic(const newgame_def& ng);
 // Initialise a game based on the choice stored in ng.
 void setup_game(const newgame_def& ng)
 {
+    replay_new_game(ng);
+
     crawl_state.type = ng.type; // by default
     if (Options.seed_from_rc && ng.type != GAME_TYPE_CUSTOM_SEED)
     {
@@ -591,6 +591,10 @@ public:
     opt_map     named_options;          // All options not caught above are
                                         // recorded here.
 
+    // Changes whenever options are reset or an option line is read, so that
+    // anything built from the options can tell when it is out of date.
+    int         generation;
+
     newgame_def game;      // Choices for new game.
 
 private:
@@ -79,6 +79,10 @@ typedef pair<plen_t, plen_t> bm_p;
 typedef map<plen_t, bm_p> bm_t;
 typedef map<plen_t, plen_t> fb_t;
 
+// Never reused, even across packages, so that a chunk version identifies one
+// particular write of a chunk.
+static uint32_t last_chunk_version = 0;
+
 package::package(const char* file, bool writeable, bool empty)
   : n_users(0), dirty(false), aborted(false)
 #ifdef DO_FSYNC
@@ -361,6 +365,7 @@ void package::finish_chunk(const string &name, plen_t at)
 {
     free_chunk(name);
     directory[name] = at;
+    versions[name] = ++last_chunk_version;
     new_chunks.insert(at);
     dirty = true;
 }
@@ -384,6 +389,7 @@ void package::delete_chunk(const string &name)
 {
     free_chunk(name);
     directory.erase(name);
+    versions.erase(name);
 }
 
 plen_t package::write_directory()
@@ -534,6 +540,7 @@ void package::read_directory(plen_t start, uint8_t version)
             string chname(ch0.name, 4);
             chname.resize(strlen(chname.c_str()));
             directory[chname] = htole(ch0.start);
+            versions[chname] = ++last_chunk_version;
             dprintf("* %s\n", chname.c_str());
         }
         break;
@@ -551,6 +558,7 @@ void package::read_directory(plen_t start, uint8_t version)
             if (rd.read(&bstart, sizeof(bstart)) != sizeof(bstart))
                 corrupted("save file corrupted -- truncated directory");
             directory[chname] = htole(bstart);
+            versions[chname] = ++last_chunk_version;
             dprintf("* %s\n", chname.c_str());
         }
         break;
@@ -565,6 +573,27 @@ bool package::has_chunk(const string &name)
     return !name.empty() && directory.count(name);
 }
 
+/// Changes whenever the chunk is written or deleted; 0 if it doesn't exist.
+uint32_t package::chunk_version(const string &name) const
+{
+    if (const uint32_t *version = map_find(versions, name))
+        return *version;
+    return 0;
+}
+
+/**
+ * Read the chunk as it is stored, without decompressing it, so that it can
+ * be decompressed with inflate_chunk() away from the package (which is not
+ * thread-safe).
+ */
+void package::read_compressed(const string &name, vector<char> &data)
+{
+    chunk_reader rd(this, name);
+    char buf[32768];
+    while (plen_t s = rd.raw_read(buf, sizeof(buf)))
+        data.insert(data.end(), buf, buf + s);
+}
+
 vector<string> package::list_chunks()
 {
     vector<string> list;
@@ -953,3 +982,40 @@ void chunk_reader::read_all(vector<char> &data)
     data.resize(at + s);
 #undef SPACE
 }
+
+/**
+ * Decompress a chunk read with package::read_compressed(). Touches nothing
+ * but its arguments, so it may run on another thread.
+ *
+ * @return false if the data was truncated or corrupt.
+ */
+bool inflate_chunk(const vector<char> &compressed, vector<unsigned char> &data)
+{
+#ifdef USE_ZLIB
+    z_stream zs;
+    zs.zalloc   = 0;
+    zs.zfree    = 0;
+    zs.opaque   = Z_NULL;
+    zs.next_in  = (Bytef*)compressed.data();
+    zs.avail_in = compressed.size();
+    if (inflateInit(&zs) != Z_OK)
+        return false;
+
+    int res = Z_OK;
+    data.resize(compressed.size() * 4 + 1024);
+    while (res == Z_OK)
+    {
+        if (zs.total_out == data.size())
+            data.resize(data.size() * 2);
+        zs.next_out  = &data[zs.total_out];
+        zs.avail_out = data.size() - zs.total_out;
+        res = inflate(&zs, Z_NO_FLUSH);
+    }
+    data.resize(zs.total_out);
+    inflateEnd(&zs);
+    return res == Z_STREAM_END;
+#else
+    data.assign(compressed.begin(), compressed.end());
+    return true;
+#endif
+}
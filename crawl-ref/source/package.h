@@ -73,6 +73,8 @@ public:
     void commit();
     void delete_chunk(const string &name);
     bool has_chunk(const string &name);
+    uint32_t chunk_version(const string &name) const;
+    void read_compressed(const string &name, vector<char> &data);
     vector<string> list_chunks();
     void abort();
     void unlink();
@@ -94,6 +96,7 @@ private:
     bool tmp;
 #endif
     map<string, plen_t> directory;
+    map<string, uint32_t> versions;
     map<plen_t, plen_t> free_blocks;
     vector<plen_t> unlinked_blocks;
     map<plen_t, pair<plen_t, plen_t> > block_map;
@@ -116,3 +119,6 @@ private:
     friend class chunk_writer;
     friend class chunk_reader;
 };
+
+bool inflate_chunk(const vector<char> &compressed,
+                   vector<unsigned char> &data);
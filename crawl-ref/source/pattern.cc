@@ -14,6 +14,10 @@
 #endif
 
 #include "pattern.h"
+
+#include <queue>
+
+#include "libutil.h"
 #include "stringutil.h"
 
 #if defined(REGEX_PCRE)
@@ -227,3 +231,297 @@ pattern_match plaintext_pattern::match_location(const string &s) const
     else
         return pattern_match::failed(s);
 }
+
+////////////////////////////////////////////////////////////////////
+// pattern_set
+
+// Skip a bracket expression; returns the index of its closing ']'.
+static size_t _skip_bracket(const string &re, size_t i)
+{
+    size_t j = i + 1;
+    if (j < re.size() && re[j] == '^')
+        j++;
+    if (j < re.size() && re[j] == ']')
+        j++;
+    while (j < re.size() && re[j] != ']')
+    {
+        if (re[j] == '[' && j + 1 < re.size()
+            && (re[j + 1] == ':' || re[j + 1] == '=' || re[j + 1] == '.'))
+        {
+            // [:alpha:] and friends
+            const size_t close = re.find(string(1, re[j + 1]) + "]", j + 2);
+            j = close == string::npos ? re.size() : close + 2;
+            continue;
+        }
+#ifdef REGEX_PCRE
+        if (re[j] == '\\')
+            j++;
+#endif
+        j++;
+    }
+    return j;
+}
+
+/**
+ * Find a piece of text which appears in every string the regex matches, or
+ * nothing if that isn't obvious. It errs on the side of finding nothing:
+ * groups, alternatives, classes and optional characters all count as
+ * unknown text.
+ *
+ * @param re    The regex.
+ * @param icase Whether it ignores case; then only ASCII is used, since
+ *              the regex library may fold other characters too.
+ * @return The longest such text, ASCII-lowercased.
+ */
+static string _required_literal(const string &re, bool icase)
+{
+    if (re.find("(?") != string::npos || re.find("\\Q") != string::npos)
+        return "";
+
+    string best, run;
+    auto end_run = [&]()
+    {
+        if (run.size() > best.size())
+            best = run;
+        run.clear();
+    };
+    // The previous character was optional: take it (all of it, if it was a
+    // multi-byte one) back off the run.
+    auto drop_last = [&]()
+    {
+        while (!run.empty() && ((unsigned char) run.back() & 0xC0) == 0x80)
+            run.pop_back();
+        if (!run.empty())
+            run.pop_back();
+    };
+
+    int depth = 0;
+    for (size_t i = 0; i < re.size(); ++i)
+    {
+        const char c = re[i];
+        if (c == '[')
+        {
+            i = _skip_bracket(re, i);
+            end_run();
+            continue;
+        }
+        if (c == '(' || c == ')')
+        {
+            depth += c == '(' ? 1 : -1;
+            end_run();
+            continue;
+        }
+        if (depth > 0)
+        {
+            if (c == '\\')
+                i++;
+            continue;
+        }
+
+        switch (c)
+        {
+        case '|':
+            return "";
+        case '?':
+        case '*':
+            drop_last();
+            end_run();
+            continue;
+        case '{':
+        {
+            drop_last();
+            end_run();
+            const size_t close = re.find('}', i);
+            if (close == string::npos)
+                return "";
+            i = close;
+            continue;
+        }
+        case '+':
+        case '.':
+        case '^':
+        case '$':
+            end_run();
+            continue;
+        }
+
+        char lit = c;
+        if (c == '\\')
+        {
+            if (++i >= re.size())
+                return "";
+            lit = re[i];
+            // \b, \d, \< and so on match no text we could know of.
+            if (lit && strchr("bBdDwWsShHvVRAzZGKX<>`'", lit))
+            {
+                end_run();
+                continue;
+            }
+            // Other escapes (\x41, \1, \p{L}...) may stand for text that
+            // isn't written as such, or take arguments that look like
+            // text: give up rather than guess.
+            if (isaalnum(lit))
+                return "";
+        }
+
+        if (icase && (unsigned char) lit >= 0x80)
+        {
+            end_run();
+            continue;
+        }
+        run += toalower(lit);
+    }
+    end_run();
+
+    // A single character would let nearly everything through.
+    return best.size() >= 2 ? best : "";
+}
+
+pattern_set::pattern_set()
+    : source(-1), built(false)
+{
+}
+
+void pattern_set::clear()
+{
+    patterns.clear();
+    literals.clear();
+    match_empty.clear();
+    source = -1;
+    built = false;
+}
+
+/**
+ * Add a pattern to the end of the set.
+ *
+ * @param pattern       The pattern.
+ * @param empty_matches If the pattern is empty, whether it matches every
+ *                      string (as in message_filter) rather than none.
+ */
+void pattern_set::add(const text_pattern &pattern, bool empty_matches)
+{
+    patterns.push_back(pattern);
+    literals.push_back(_required_literal(pattern.tostring(),
+                                         pattern.ignores_case()));
+    match_empty.push_back(empty_matches && pattern.empty());
+    built = false;
+}
+
+void pattern_set::build() const
+{
+    nodes.assign(1, ac_node());
+    nodes[0].fail = 0;
+    always.clear();
+
+    for (int i = 0; i < (int) patterns.size(); ++i)
+    {
+        if (literals[i].empty())
+        {
+            always.push_back(i);
+            continue;
+        }
+
+        int node = 0;
+        for (unsigned char c : literals[i])
+        {
+            auto edge = nodes[node].next.find(c);
+            if (edge == nodes[node].next.end())
+            {
+                nodes.emplace_back();
+                nodes.back().fail = 0;
+                edge = nodes[node].next.emplace(c, nodes.size() - 1).first;
+            }
+            node = edge->second;
+        }
+        nodes[node].out.push_back(i);
+    }
+
+    // Breadth first, so that a node's failure link is done before its
+    // children need it.
+    queue<int> todo;
+    for (const auto &edge : nodes[0].next)
+        todo.push(edge.second);
+    while (!todo.empty())
+    {
+        const int node = todo.front();
+        todo.pop();
+        for (const auto &edge : nodes[node].next)
+        {
+            int fail = nodes[node].fail;
+            while (fail && !nodes[fail].next.count(edge.first))
+                fail = nodes[fail].fail;
+            auto target = nodes[fail].next.find(edge.first);
+            const int child = edge.second;
+            nodes[child].fail = target != nodes[fail].next.end()
+                                && target->second != child
+                                ? target->second : 0;
+            const vector<int> &inherited = nodes[nodes[child].fail].out;
+            nodes[child].out.insert(nodes[child].out.end(),
+                                    inherited.begin(), inherited.end());
+            todo.push(child);
+        }
+    }
+
+    built = true;
+}
+
+// Which patterns might match s, from a single pass over it.
+void pattern_set::candidates(const string &s, vector<bool> &cand) const
+{
+    if (!built)
+        build();
+
+    cand.assign(patterns.size(), false);
+    for (int i : always)
+        cand[i] = true;
+
+    int node = 0;
+    for (char ch : s)
+    {
+        const unsigned char c = toalower(ch);
+        auto edge = nodes[node].next.find(c);
+        while (node && edge == nodes[node].next.end())
+        {
+            node = nodes[node].fail;
+            edge = nodes[node].next.find(c);
+        }
+        node = edge == nodes[node].next.end() ? 0 : edge->second;
+        for (int i : nodes[node].out)
+            cand[i] = true;
+    }
+}
+
+/**
+ * Find the first pattern (in the order they were added) that matches.
+ *
+ * @param s      The string to test.
+ * @param accept If given, only patterns for whose index it returns true
+ *               are considered; it is called before running the regex.
+ * @return The index of the pattern, or -1 if none matched.
+ */
+int pattern_set::first_match(const string &s,
+                             const function<bool(int)> &accept) const
+{
+    vector<bool> cand;
+    candidates(s, cand);
+    for (int i = 0; i < (int) patterns.size(); ++i)
+    {
+        if (!cand[i] || (accept && !accept(i)))
+            continue;
+        if (match_empty[i] || patterns[i].matches(s))
+            return i;
+    }
+    return -1;
+}
+
+/// The indices of all the patterns that match, in ascending order.
+vector<int> pattern_set::all_matches(const string &s) const
+{
+    vector<bool> cand;
+    candidates(s, cand);
+    vector<int> found;
+    for (int i = 0; i < (int) patterns.size(); ++i)
+        if (cand[i] && (match_empty[i] || patterns[i].matches(s)))
+            found.push_back(i);
+    return found;
+}
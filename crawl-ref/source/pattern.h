@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 class pattern_match
 {
 public:
@@ -116,6 +118,8 @@ public:
         return pattern;
     }
 
+    bool ignores_case() const { return ignore_case; }
+
 private:
     string pattern;
     mutable void *compiled_pattern;
@@ -154,3 +158,52 @@ private:
     string pattern;
     bool ignore_case;
 };
+
+/**
+ * @class pattern_set
+ * A list of text_patterns which are tried against the same strings, such as
+ * the force_more_message option.
+ *
+ * Each regex is scanned for a piece of literal text that every match must
+ * contain, and all of those go into one Aho-Corasick automaton. A single
+ * pass over a string then says which patterns could match it, and only
+ * those are run. Patterns without such text are always run. Results come
+ * in the order the patterns were added, so "first match wins" lists keep
+ * working the same way.
+ */
+class pattern_set
+{
+public:
+    pattern_set();
+
+    void clear();
+    void add(const text_pattern &pattern, bool empty_matches = false);
+    size_t size() const { return patterns.size(); }
+
+    int first_match(const string &s,
+                    const function<bool(int)> &accept = nullptr) const;
+    vector<int> all_matches(const string &s) const;
+
+    // For the owner's use: what the set was last built from, e.g. an
+    // Options.generation. -1 when new or cleared.
+    int source;
+
+private:
+    struct ac_node
+    {
+        map<unsigned char, int> next;
+        int fail;
+        vector<int> out;    // patterns whose literal ends here
+    };
+
+    void build() const;
+    void candidates(const string &s, vector<bool> &cand) const;
+
+    vector<text_pattern> patterns;
+    vector<string> literals;        // lowercased; empty if none was found
+    vector<bool> match_empty;       // empty patterns that match anything
+
+    mutable bool built;
+    mutable vector<ac_node> nodes;
+    mutable vector<int> always;     // patterns without a literal
+};
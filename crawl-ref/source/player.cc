@@ -934,16 +934,15 @@ int player::wearing_ego(equipment_type slot, int special, bool calc_unid) const
         break;
 
     case EQ_ALL_ARMOUR:
-        // Check all armour slots:
-        for (int i = EQ_MIN_ARMOUR; i <= EQ_MAX_ARMOUR; i++)
+        if (calc_unid && special >= 0 && special < NUM_SPECIAL_ARMOURS)
         {
-            if ((item = slot_item(static_cast<equipment_type>(i)))
-                && get_armour_ego_type(*item) == special
-                && (calc_unid || item_type_known(*item)))
-            {
-                ret++;
-            }
+            ret = _equip_totals().armour_ego[special];
+#ifdef DEBUG
+            ASSERT(ret == _wearing_armour_ego(special, calc_unid));
+#endif
         }
+        else
+            ret = _wearing_armour_ego(special, calc_unid);
         break;
 
     default:
@@ -962,6 +961,23 @@ int player::wearing_ego(equipment_type slot, int special, bool calc_unid) const
     return ret;
 }
 
+// How many armour slots hold an item of ego type "special".
+int player::_wearing_armour_ego(int special, bool calc_unid) const
+{
+    int ret = 0;
+    for (int i = EQ_MIN_ARMOUR; i <= EQ_MAX_ARMOUR; i++)
+    {
+        const item_def *item = slot_item(static_cast<equipment_type>(i));
+        if (item
+            && get_armour_ego_type(*item) == special
+            && (calc_unid || item_type_known(*item)))
+        {
+            ret++;
+        }
+    }
+    return ret;
+}
+
 // Returns true if the indicated unrandart is equipped
 // [ds] There's no equivalent of calc_unid or req_id because as of now, weapons
 // and armour type-id on wield/wear.
@@ -3814,12 +3830,27 @@ int slaying_bonus(bool ranged)
 }
 
 // Checks each equip slot for a randart, and adds up all of those with
-// a given property. Slow if any randarts are worn, so avoid where
-// possible. If `matches' is non-nullptr, items with nonzero property are
-// pushed onto *matches.
+// a given property. The totals for everything worn are kept between calls,
+// so this is only slow when asking for the unidentified total or for the
+// matching items. If `matches' is non-nullptr, items with nonzero property
+// are pushed onto *matches.
 int player::scan_artefacts(artefact_prop_type which_property,
                            bool calc_unid,
                            vector<item_def> *matches) const
+{
+    if (!calc_unid || matches)
+        return _scan_artefacts(which_property, calc_unid, matches);
+
+    const int retval = _equip_totals().artp[which_property];
+#ifdef DEBUG
+    ASSERT(retval == _scan_artefacts(which_property, calc_unid, nullptr));
+#endif
+    return retval;
+}
+
+int player::_scan_artefacts(artefact_prop_type which_property,
+                            bool calc_unid,
+                            vector<item_def> *matches) const
 {
     int retval = 0;
 
@@ -3850,6 +3881,59 @@ int player::scan_artefacts(artefact_prop_type which_property,
     return retval;
 }
 
+/**
+ * The artefact properties and armour egos of everything worn, as
+ * scan_artefacts() and wearing_ego() would add them up. Worked out again
+ * whenever what is worn or melded has changed since the last time; the
+ * items themselves don't change while worn.
+ */
+const player::equip_totals &player::_equip_totals() const
+{
+    equip_totals &totals = m_equip_totals;
+    bool same = totals.valid;
+    for (int i = EQ_FIRST_EQUIP; same && i < NUM_EQUIP; ++i)
+        same = totals.equip[i] == equip[i] && totals.melded[i] == melded[i];
+    if (same)
+        return totals;
+
+    for (int i = EQ_FIRST_EQUIP; i < NUM_EQUIP; ++i)
+    {
+        totals.equip[i] = equip[i];
+        totals.melded.set(i, melded[i]);
+    }
+
+    totals.artp.init(0);
+    for (int i = EQ_FIRST_EQUIP; i < NUM_EQUIP; ++i)
+    {
+        if (melded[i] || equip[i] == -1)
+            continue;
+
+        const item_def &item = inv[equip[i]];
+        if (i == EQ_WEAPON && item.base_type != OBJ_WEAPONS
+            || !is_artefact(item))
+        {
+            continue;
+        }
+
+        artefact_properties_t item_props;
+        artefact_properties(item, item_props);
+        for (int p = 0; p < ARTP_NUM_PROPERTIES; ++p)
+            totals.artp[p] += item_props[p];
+    }
+
+    totals.armour_ego.init(0);
+    for (int i = EQ_MIN_ARMOUR; i <= EQ_MAX_ARMOUR; i++)
+        if (const item_def *item = slot_item(static_cast<equipment_type>(i)))
+        {
+            const int ego = get_armour_ego_type(*item);
+            if (ego >= 0 && ego < NUM_SPECIAL_ARMOURS)
+                totals.armour_ego[ego]++;
+        }
+
+    totals.valid = true;
+    return totals;
+}
+
 void dec_hp(int hp_loss, bool fatal, const char *aux)
 {
     ASSERT(!crawl_state.game_is_arena());
@@ -5339,6 +5423,7 @@ player::player()
     equip.init(-1);
     melded.reset();
     unrand_reacts.reset();
+    m_equip_totals.valid = false;
     last_unequip = -1;
 
     symbol          = MONS_PLAYER;
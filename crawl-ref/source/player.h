@@ -901,6 +901,23 @@ public:
     bool clear_far_engulf() override;
 
 protected:
+    // What everything worn adds up to, counting unidentified items, and the
+    // equipment that was worked out for. See _equip_totals().
+    struct equip_totals
+    {
+        bool valid = false;
+        FixedVector<int, NUM_EQUIP> equip;
+        FixedBitVector<NUM_EQUIP> melded;
+        FixedVector<int, ARTP_NUM_PROPERTIES> artp;
+        FixedVector<int, NUM_SPECIAL_ARMOURS> armour_ego;
+    };
+    mutable equip_totals m_equip_totals;
+
+    const equip_totals &_equip_totals() const;
+    int _scan_artefacts(artefact_prop_type which_property, bool calc_unid,
+                        vector<item_def> *matches) const;
+    int _wearing_armour_ego(int special, bool calc_unid) const;
+
     void _removed_beholder(bool quiet = false);
     bool _possible_beholder(const monster* mon) const;
 
@@ -1380,6 +1380,7 @@ void mons_make_god_gift(monster& mon, god_type god)
 
     mon.god = god;
     mon.flags |= MF_GOD_GIFT;
+    mon.info_changed();
 }
 
 bool mons_is_god_gift(const monster& mon, god_type god)
@@ -1568,6 +1569,7 @@ void upgrade_hepliaklqana_ancestor(bool quiet_force)
     ancestor->mname = hepliaklqana_ally_name();
     ancestor->props[MON_GENDER_KEY]
         = you.props[HEPLIAKLQANA_ALLY_GENDER_KEY].get_int();
+    ancestor->info_changed();
 
     const int old_hd = ancestor->get_experience_level();
     const int hd = _hepliaklqana_ally_hd();
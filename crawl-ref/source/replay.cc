@@ -0,0 +1,247 @@
+/**
+ * @file
+ * @brief Record the keystrokes of a game and replay them as a benchmark.
+ *
+ * "-record <file>" writes the seed, version and character of a new game,
+ * followed by every key read from the terminal. "-replay <file>" starts the
+ * same character with the same seed and feeds those keys back in, with
+ * delays and throttling turned off, then reports how long the replay took
+ * together with the turn loop profile. Running the same log on two builds
+ * gives comparable timings, as long as the rc file is the same.
+ *
+ * Key-press polling (kbhit) always reports no input while recording or
+ * replaying, so that interruptions of travel, resting or command repetition
+ * depend only on the keys themselves and not on when they were typed.
+**/
+
+#include "AppHdr.h"
+
+#include "replay.h"
+
+#include <chrono>
+
+#include "cio.h"
+#include "end.h"
+#include "initfile.h"
+#include "jobs.h"
+#include "newgame-def.h"
+#include "options.h"
+#include "player.h"
+#include "species.h"
+#include "state.h"
+#include "stringutil.h"
+#include "syscalls.h"
+#include "turn-profile.h"
+#include "version.h"
+
+#define REPLAY_HEADER "# crawl keystroke log"
+
+static FILE *record_log = nullptr;
+static newgame_def recorded_game;
+static bool have_new_game = false;
+
+static bool replaying = false;
+static bool replay_wizard = false;
+static string replay_version;
+static vector<int> replay_keys;
+static size_t replay_pos = 0;
+static chrono::steady_clock::time_point replay_start;
+static bool replay_started = false;
+
+/**
+ * Read a keystroke log given with -replay and set up the options so that
+ * the recorded character starts without going through the menus.
+ */
+void replay_load(const string &file)
+{
+    FILE *f = fopen_u(file.c_str(), "r");
+    if (!f)
+        end(1, true, "Can't open keystroke log %s", file.c_str());
+
+    map<string, string> header;
+    bool valid = false;
+    char line[1024];
+    while (fgets(line, sizeof line, f))
+    {
+        string entry = line;
+        trim_string(entry);
+        if (entry == REPLAY_HEADER)
+            valid = true;
+        else if (entry == "keys:")
+            break;
+        else if (entry.empty() || entry[0] == '#')
+            continue;
+
+        const vector<string> kv = split_string(":", entry, true, true, 1);
+        if (kv.size() == 2)
+            header[kv[0]] = kv[1];
+    }
+
+    int key;
+    while (fscanf(f, "%d", &key) == 1)
+        replay_keys.push_back(key);
+    fclose(f);
+
+    if (!valid || header["name"].empty())
+        end(1, false, "%s is not a keystroke log.\n", file.c_str());
+
+    uint64_t seed = 0;
+    if (sscanf(header["seed"].c_str(), "%" SCNu64, &seed) != 1)
+        end(1, false, "Keystroke log %s has no seed.\n", file.c_str());
+
+    newgame_def &game = Options.game;
+    game.name    = header["name"];
+    game.type    = static_cast<game_type>(atoi(header["type"].c_str()));
+    // The seed is forced below, which makes a normal game a custom seed
+    // one without going through the seed menu.
+    if (game.type == GAME_TYPE_CUSTOM_SEED)
+        game.type = GAME_TYPE_NORMAL;
+    game.species = get_species_by_abbrev(header["species"].c_str());
+    game.job     = get_job_by_abbrev(header["background"].c_str());
+    game.weapon  = static_cast<weapon_type>(atoi(header["weapon"].c_str()));
+    game.map     = header["map"];
+    crawl_state.sprint_map = game.map;
+    Options.seed_from_rc = Options.seed = seed;
+
+    replay_wizard  = header["wizard"] == "true";
+    replay_version = header["version"];
+
+    // Start straight away, and never touch a real save.
+    Options.no_save = true;
+    Options.name_bypasses_menu = true;
+    Options.restart_after_game = MB_FALSE;
+    crawl_state.throttle = false;
+    crawl_state.disables.set(DIS_DELAY);
+
+    replaying = true;
+}
+
+/// Remember the choices a new game was started with, for -record.
+void replay_new_game(const newgame_def &ng)
+{
+    recorded_game = ng;
+    have_new_game = true;
+}
+
+/**
+ * A game has just been set up: open the -record log, or start the clock of
+ * a -replay.
+ */
+void replay_game_started()
+{
+    if (replaying)
+    {
+        // -no-save turns on wizard mode; match the recorded game instead.
+        you.wizard = replay_wizard;
+        prof_reset();
+        replay_start = chrono::steady_clock::now();
+        replay_started = true;
+        return;
+    }
+
+    if (SysEnv.record_file.empty() || !have_new_game || record_log)
+        return;
+
+    record_log = fopen_u(SysEnv.record_file.c_str(), "w");
+    if (!record_log)
+    {
+        fprintf(stderr, "Can't write keystroke log %s\n",
+                SysEnv.record_file.c_str());
+        return;
+    }
+
+    fprintf(record_log, "%s\n", REPLAY_HEADER);
+    fprintf(record_log, "version:%s\n", Version::Long);
+    fprintf(record_log, "seed:%" PRIu64 "\n", crawl_state.seed);
+    fprintf(record_log, "name:%s\n", recorded_game.name.c_str());
+    fprintf(record_log, "type:%d\n", recorded_game.type);
+    fprintf(record_log, "species:%s\n",
+            get_species_abbrev(recorded_game.species));
+    fprintf(record_log, "background:%s\n",
+            get_job_abbrev(recorded_game.job));
+    fprintf(record_log, "weapon:%d\n", recorded_game.weapon);
+    fprintf(record_log, "map:%s\n", recorded_game.map.c_str());
+    fprintf(record_log, "wizard:%s\n", you.wizard ? "true" : "false");
+    fprintf(record_log, "keys:\n");
+    fflush(record_log);
+}
+
+/**
+ * Close the log of a recording, or report the timings of a replay. Called
+ * on exit, whether the keys ran out or the game ended first.
+ */
+void replay_finish()
+{
+    if (record_log)
+    {
+        fprintf(record_log, "\n");
+        fclose(record_log);
+        record_log = nullptr;
+    }
+
+    if (!replaying || !replay_started)
+        return;
+    replaying = false;
+
+    const double secs = chrono::duration_cast<chrono::duration<double>>(
+                            chrono::steady_clock::now() - replay_start).count();
+    const int turns = prof_turns();
+
+    string report;
+    report += make_stringf("Replay of %s\n", Options.game.name.c_str());
+    report += make_stringf("recorded with: %s\n", replay_version.c_str());
+    report += make_stringf("replayed with: %s\n", Version::Long);
+    report += make_stringf("seed:          %" PRIu64 "\n", crawl_state.seed);
+    report += make_stringf("keys:          %u of %u\n",
+                           (unsigned int) replay_pos,
+                           (unsigned int) replay_keys.size());
+    report += make_stringf("game turns:    %d\n", you.num_turns);
+    report += make_stringf("total time:    %.3f s\n", secs);
+    if (turns)
+    {
+        report += make_stringf("time per turn: %.3f ms\n",
+                               secs * 1000 / turns);
+    }
+    report += "\n" + prof_report();
+
+    const string file = SysEnv.report_file.empty() ? "replay-bench.txt"
+                                                   : SysEnv.report_file;
+    if (FILE *out = fopen_u(file.c_str(), "w"))
+    {
+        fprintf(out, "%s", report.c_str());
+        fclose(out);
+    }
+    // stdout belongs to the terminal (or fake_pty), so summarise on stderr.
+    fprintf(stderr, "replay: %d turns in %.3f s (%u keys); report in %s\n",
+            turns, secs, (unsigned int) replay_pos, file.c_str());
+}
+
+/// Are keys being read from a keystroke log? Only once the game is running:
+/// anything before that was not recorded either.
+bool replay_active()
+{
+    return replaying && replay_started;
+}
+
+/// Should polling for key presses always report that there are none?
+bool replay_fixed_input()
+{
+    return replaying || record_log;
+}
+
+/// The next recorded key. Exits the game once the log has been used up.
+int replay_next_key()
+{
+    if (replay_pos >= replay_keys.size())
+        end(0);
+    return replay_keys[replay_pos++];
+}
+
+void replay_record_key(int key)
+{
+    if (!record_log || key == CK_MOUSE_MOVE || key == CK_MOUSE_CLICK)
+        return;
+
+    fprintf(record_log, "%d\n", key);
+    fflush(record_log);
+}
@@ -0,0 +1,18 @@
+/**
+ * @file
+ * @brief Record the keystrokes of a game and replay them as a benchmark.
+**/
+
+#pragma once
+
+struct newgame_def;
+
+void replay_load(const string &file);
+void replay_new_game(const newgame_def &ng);
+void replay_game_started();
+void replay_finish();
+
+bool replay_active();
+bool replay_fixed_input();
+int replay_next_key();
+void replay_record_key(int key);
@@ -5,6 +5,41 @@
 #include <cassert>
 #include "tile.h"
 #include <algorithm>
+#if !defined(__MINGW32__) || defined(_GLIBCXX_HAS_GTHREADS)
+#include <thread>
+#define TILEGEN_THREADS
+#endif
+
+// Call f(i) for every i in [0, n), spread over all cores. Each call must
+// only write to what belongs to its own i.
+template <class F>
+static void _parallel_for(unsigned int n, F f)
+{
+    unsigned int workers = 1;
+#ifdef TILEGEN_THREADS
+    workers = min(max(thread::hardware_concurrency(), 1U), n);
+#endif
+    if (workers <= 1)
+    {
+        for (unsigned int i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+
+#ifdef TILEGEN_THREADS
+    vector<thread> threads;
+    for (unsigned int w = 0; w < workers; w++)
+    {
+        threads.emplace_back([=, &f]()
+        {
+            for (unsigned int i = w; i < n; i += workers)
+                f(i);
+        });
+    }
+    for (thread &t : threads)
+        t.join();
+#endif
+}
 
 tile_page::tile_page() : m_width(1024), m_height(0)
 {
@@ -30,22 +65,33 @@ bool tile_page::place_images()
     m_offsets.clear();
     m_texcoords.clear();
 
+    // Finding the bounding boxes means looking at every pixel, so do that
+    // for all tiles at once before placing them in order.
+    vector<int> boxes(m_tiles.size() * 4);
+    _parallel_for(m_tiles.size(), [&](unsigned int i)
+    {
+        int *box = &boxes[i * 4];
+        if (m_tiles[i]->shrink())
+            m_tiles[i]->get_bounding_box(box[0], box[1], box[2], box[3]);
+        else
+        {
+            box[0] = 0;
+            box[1] = 0;
+            box[2] = m_tiles[i]->width();
+            box[3] = m_tiles[i]->height();
+        }
+    });
+
     int ymin, ycur, ymax;
     int xmin, xcur, xmax;
     ymin = ycur = ymax = xmin = xcur = xmax = 0;
 
     for (unsigned int i = 0; i < m_tiles.size(); i++)
     {
-        int ofs_x, ofs_y, tilew, tileh;
-        if (m_tiles[i]->shrink())
-            m_tiles[i]->get_bounding_box(ofs_x, ofs_y, tilew, tileh);
-        else
-        {
-            ofs_x = 0;
-            ofs_y = 0;
-            tilew = m_tiles[i]->width();
-            tileh = m_tiles[i]->height();
-        }
+        const int ofs_x = boxes[i * 4];
+        const int ofs_y = boxes[i * 4 + 1];
+        const int tilew = boxes[i * 4 + 2];
+        const int tileh = boxes[i * 4 + 3];
 
         m_offsets.push_back(ofs_x);
         m_offsets.push_back(ofs_y);
@@ -139,29 +185,38 @@ bool tile_page::write_image(const char *filename)
     tile_colour *pixels = new tile_colour[m_width * m_height];
     memset(pixels, 0, m_width * m_height * sizeof(tile_colour));
 
-    for (unsigned int i = 0; i < m_tiles.size(); i++)
+    // Composite the page in bands of rows, each band copying every tile in
+    // order, so the result is the same as doing it all in one go.
+    const int band_height = 32;
+    const int bands = (m_height + band_height - 1) / band_height;
+    _parallel_for(bands, [&](unsigned int band)
     {
-        int sx = m_texcoords[i*4];
-        int sy = m_texcoords[i*4+1];
-        int ex = m_texcoords[i*4+2];
-        int ey = m_texcoords[i*4+3];
-        int wx = ex - sx;
-        int wy = ey - sy;
-        int ofs_x = m_offsets[i*4];
-        int ofs_y = m_offsets[i*4+1];
-
-        for (int y = 0; y < wy; y++)
-            for (int x = 0; x < wx; x++)
-            {
-                tile_colour &dest = pixels[(sx+x) + (sy+y)*m_width];
-                tile_colour &src = m_tiles[i]->get_pixel(ofs_x+x, ofs_y+y);
-                dest = src;
+        const int band_y0 = band * band_height;
+        const int band_y1 = min(band_y0 + band_height, m_height);
 
-                // Clear colour from transparent areas.
-                if (!dest.a)
-                    dest = tile_colour::transparent;
-            }
-    }
+        for (unsigned int i = 0; i < m_tiles.size(); i++)
+        {
+            int sx = m_texcoords[i*4];
+            int sy = m_texcoords[i*4+1];
+            int ex = m_texcoords[i*4+2];
+            int ey = m_texcoords[i*4+3];
+            int wx = ex - sx;
+            int ofs_x = m_offsets[i*4];
+            int ofs_y = m_offsets[i*4+1];
+
+            for (int y = max(sy, band_y0) - sy; y < min(ey, band_y1) - sy; y++)
+                for (int x = 0; x < wx; x++)
+                {
+                    tile_colour &dest = pixels[(sx+x) + (sy+y)*m_width];
+                    tile_colour &src = m_tiles[i]->get_pixel(ofs_x+x, ofs_y+y);
+                    dest = src;
+
+                    // Clear colour from transparent areas.
+                    if (!dest.a)
+                        dest = tile_colour::transparent;
+                }
+        }
+    });
 
     bool success = write_png(filename, pixels, m_width, m_height);
     delete[] pixels;
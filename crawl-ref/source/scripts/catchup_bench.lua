@@ -0,0 +1,45 @@
+-- Times coming back to a level crowded with awake monsters after a long
+-- absence, next to coming back after a short one.
+-- To crowd a fresh D:12 with 500 monsters and come back after 10000 turns,
+-- run it with:
+-- crawl -script catchup_bench 10000 D:12 500
+
+local args = script.simple_args()
+local turns = tonumber(args[1] or 10000)
+local place = args[2] or "D:12"
+local monsters = tonumber(args[3] or 500)
+if not turns or not monsters then
+  script.usage("Usage: catchup_bench [turns] [place] [monsters]")
+end
+
+local function crowd_level()
+  local you_x, you_y = you.pos()
+  local placed = 0
+  while placed < monsters do
+    local before = placed
+    for y = 1, dgn.GYM - 2 do
+      for x = 1, dgn.GXM - 2 do
+        if placed < monsters
+           and (x ~= you_x or y ~= you_y)
+           and dgn.is_passable(x, y)
+           and not dgn.mons_at(x, y)
+           and crawl.one_chance_in(4)
+           and dgn.create_monster(x, y, "random generate_awake") then
+          placed = placed + 1
+        end
+      end
+    end
+    if placed == before then
+      break
+    end
+  end
+  return placed
+end
+
+for _, away in ipairs({ 10, turns }) do
+  test.regenerate_level(place)
+  local placed = crowd_level()
+  crawl.stderr(string.format("%s with %d more monsters, back after %d turns:",
+                             place, placed, away))
+  crawl.stderr(debug.catchup_bench(away))
+end
@@ -0,0 +1,15 @@
+-- Times the monster class data lookups made for every monster on a level.
+-- To go over the monsters of a fresh Elf:3 1000 times, run it with:
+-- crawl -script mon_class_bench 1000 Elf:3
+
+local args = script.simple_args()
+local iterations = tonumber(args[1] or 1000)
+local place = args[2] or "Elf:3"
+if not iterations then
+  script.usage("Usage: mon_class_bench [iterations] [place]")
+end
+
+test.regenerate_level(place)
+
+crawl.stderr(string.format("%d lookups per monster of %s:", iterations, place))
+crawl.stderr(debug.mon_class_bench(iterations))
@@ -0,0 +1,17 @@
+-- Times the tile lookups of redrawing a whole, mapped level.
+-- To time 100 redraws of a fresh Lair:2, run it with:
+-- crawl -script tile_bench 100 Lair:2
+
+local args = script.simple_args()
+local iterations = tonumber(args[1] or 100)
+local place = args[2] or "D:1"
+if not iterations then
+  script.usage("Usage: tile_bench [iterations] [place]")
+end
+
+you.enter_wizard_mode()
+test.regenerate_level(place)
+wiz.map_level()
+
+crawl.stderr(string.format("%d redraws of %s:", iterations, place))
+crawl.stderr(debug.tile_bench(iterations))
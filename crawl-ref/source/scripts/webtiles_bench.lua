@@ -0,0 +1,17 @@
+-- Times writing full webtiles player and map messages for a mapped level.
+-- Needs a webtiles build. To time 100 frames of a fresh Lair:2, run it with:
+-- crawl -script webtiles_bench 100 Lair:2
+
+local args = script.simple_args()
+local iterations = tonumber(args[1] or 100)
+local place = args[2] or "D:1"
+if not iterations then
+  script.usage("Usage: webtiles_bench [iterations] [place]")
+end
+
+you.enter_wizard_mode()
+test.regenerate_level(place)
+wiz.map_level()
+
+crawl.stderr(string.format("%d frames of %s:", iterations, place))
+crawl.stderr(debug.webtiles_bench(iterations))
@@ -33,6 +33,7 @@
 #include "state.h"
 #include "stringutil.h"
 #include "terrain.h"
+#include "turn-profile.h"
 #include "view.h"
 #include "viewchar.h"
 
@@ -771,6 +772,8 @@ void yell(const actor* mon)
 
 void apply_noises()
 {
+    prof_timer timer(PROF_NOISES);
+
     // [ds] This copying isn't awesome, but we cannot otherwise handle
     // the case where one set of noises wakes up monsters who then let
     // out yips of their own, modifying _noise_grid while it is in the
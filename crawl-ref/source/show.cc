@@ -105,6 +105,18 @@ bool show_type::is_cleanable_monster() const
     return cls == SH_MONSTER && !mons_class_is_stationary(mons);
 }
 
+// What happens each time the player sees a cell, whether or not it changed.
+static void _notice_feat_at(const coord_def &gp, dungeon_feature_type feat)
+{
+    // Tell the world first.
+    dungeon_events.fire_position_event(DET_PLAYER_IN_LOS, gp);
+
+    if (is_notable_terrain(feat))
+        seen_notable_thing(feat, gp);
+
+    dgn_seen_vault_at(gp);
+}
+
 static void _update_feat_at(const coord_def &gp)
 {
     if (!you.see_cell(gp))
@@ -176,13 +188,7 @@ static void _update_feat_at(const coord_def &gp)
     if (emphasise(gp))
         env.map_knowledge(gp).flags |= MAP_EMPHASIZE;
 
-    // Tell the world first.
-    dungeon_events.fire_position_event(DET_PLAYER_IN_LOS, gp);
-
-    if (is_notable_terrain(feat))
-        seen_notable_thing(feat, gp);
-
-    dgn_seen_vault_at(gp);
+    _notice_feat_at(gp, feat);
 }
 
 static show_item_type _item_to_show_code(const item_def &item)
@@ -423,8 +429,7 @@ static void _update_monster(monster* mons)
     if (mons->visible_to(&you))
     {
         mons->ensure_has_client_id();
-        monster_info mi(mons);
-        env.map_knowledge(gp).set_monster(mi);
+        env.map_knowledge(gp).set_monster(get_cached_monster_info(mons));
         return;
     }
 
@@ -525,6 +530,59 @@ void show_update_at(const coord_def &gp, layers_type layers)
 #endif
 }
 
+// What show_init() last left in the map knowledge, which cells it updated
+// and with which layers.
+static MapKnowledge _shown_knowledge;
+static FixedBitArray<GXM, GYM> _shown_cells;
+static layers_type _shown_layers = LAYERS_ALL;
+
+// Does anything other than the level grids decide how the cells in view are
+// shown? If so, update them all.
+static bool _show_needs_full_update(layers_type layers)
+{
+    return layers != LAYERS_ALL || _shown_layers != LAYERS_ALL
+           || areas_present()
+           || you.beheld() || you.afraid() || you.is_nervous()
+           || env.level_state & LSTATE_SLIMY_WALL;
+}
+
+/**
+ * Would show_update_at() leave a visible cell as it is? That is the case if
+ * the grids there are as they were the last time it was updated, and its
+ * map knowledge is just as that left it. Cells with monsters, items or
+ * clouds change without the grids doing so, and how stairs, transporters
+ * and traps look depends on the travel cache and exclusions, so those are
+ * always updated.
+ */
+static bool _show_unchanged_at(const coord_def &gp, bool grids_changed)
+{
+    if (grids_changed || !_shown_cells(gp) || !you.see_cell(gp))
+        return false;
+
+    const dungeon_feature_type feat = grd(gp);
+    if (monster_at(gp) || igrd(gp) != NON_ITEM || cloud_at(gp)
+        || feat_is_stair(feat) || feat_is_escape_hatch(feat)
+        || feat == DNGN_TRANSPORTER || feat_is_trap(feat))
+    {
+        return false;
+    }
+
+    // Visibility is set after show_init(), and "seen" and "changed" are
+    // left alone by it.
+    const uint32_t ignored = MAP_VISIBLE_FLAG | MAP_SEEN_FLAG
+                             | MAP_CHANGED_FLAG;
+    const uint32_t stale = MAP_DETECTED_MONSTER | MAP_INVISIBLE_MONSTER
+                           | MAP_DETECTED_ITEM | MAP_INVISIBLE_UPDATE;
+    const map_cell &now = env.map_knowledge.get(gp);
+    const map_cell &then = _shown_knowledge.get(gp);
+    return !(now.flags & stale)
+           && !((now.flags ^ then.flags) & ~ignored)
+           && now.feat() == then.feat()
+           && now.feat_colour() == then.feat_colour()
+           && now.trap() == then.trap()
+           && !now.monsterinfo() && !now.item() && now.cloud() == CLOUD_NONE;
+}
+
 void show_init(layers_type layers)
 {
     clear_terrain_visibility();
@@ -539,16 +597,37 @@ void show_init(layers_type layers)
         return;
     }
 
+    env.grid_changes.start_look();
+    const bool full = _show_needs_full_update(layers);
+
     vector <coord_def> update_locs;
-    for (radius_iterator ri(you.pos(), you.xray_vision ? LOS_NONE : LOS_DEFAULT); ri; ++ri)
+    FixedBitArray<GXM, GYM> shown;
+    for (visible_radius_iterator ri(you.pos(), you.xray_vision ? LOS_NONE : LOS_DEFAULT); ri; ++ri)
     {
-        show_update_at(*ri, layers);
+        const bool changed = env.grid_changes.check(*ri);
+        if (full || !_show_unchanged_at(*ri, changed))
+            show_update_at(*ri, layers);
+        else
+        {
+            _notice_feat_at(*ri, grd(*ri));
+#ifdef USE_TILE
+            tile_draw_map_cell(*ri, true);
+#endif
+#ifdef USE_TILE_WEB
+            tiles.mark_for_redraw(*ri);
+#endif
+        }
+        shown.set(*ri);
         update_locs.push_back(*ri);
     }
 
     // Need to clear these update flags now so they don't persist.
     for (coord_def loc : update_locs)
         env.map_knowledge(loc).flags &= ~MAP_INVISIBLE_UPDATE;
+
+    _shown_knowledge = env.map_knowledge;
+    _shown_cells = shown;
+    _shown_layers = layers;
 }
 
 // Emphasis may change while off-level. This catches up.
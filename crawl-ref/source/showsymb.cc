@@ -555,7 +555,7 @@ cglyph_t get_cell_glyph(const coord_def& loc, bool only_stationary_monsters,
 {
     // note: this does NOT determine output of the player glyph;
     // that's handled by itself in _draw_player() in view.cc
-    const map_cell& cell = env.map_knowledge(loc);
+    const map_cell& cell = env.map_knowledge.get(loc);
     const show_class cell_show_class =
         get_cell_show_class(cell, only_stationary_monsters);
     return _get_cell_glyph_with_class(cell, loc, cell_show_class, colour_mode);
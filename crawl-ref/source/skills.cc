@@ -49,6 +49,7 @@
 
 static int _train(skill_type exsk, int &max_exp, bool simu = false);
 static void _train_skills(int exp, const int cost, const bool simu);
+static bool _gnoll_train_batch();
 static int _training_target_skill_point_diff(skill_type exsk, int training_target);
 
 // Basic goals for titles:
@@ -959,6 +960,9 @@ void train_skills(bool simu)
             cost = _gnoll_total_skill_cost();
             if (exp >= cost)
             {
+                // Projections can take the rounds that cost the same at once.
+                if (simu && _gnoll_train_batch())
+                    continue;
                 _train_skills(exp, calc_skill_cost(you.skill_cost_level), simu);
                 dprf(DIAG_SKILLS,
                     "Trained all gnoll skills by 1 at total cost %d.", cost);
@@ -1292,6 +1296,77 @@ int _gnoll_total_skill_cost()
     return total_cost;
 }
 
+/**
+ * Do as many rounds of gnoll training (a skill point to every skill being
+ * trained) as possible in one go, as long as the result is the same as
+ * doing them one at a time with simulated training: every point has to cost
+ * the same, without random rounding, and no skill may reach level 27 or run
+ * out of manual before the last round.
+ *
+ * @return whether at least two rounds were done.
+ */
+static bool _gnoll_train_batch()
+{
+    const int num = _total_skill_count();
+    const int denom = num - _useless_skill_count();
+    int point_cost = calc_skill_cost(you.skill_cost_level);
+    if (num != denom)
+    {
+        if (num * point_cost % denom)
+            return false;
+        point_cost = num * point_cost / denom;
+    }
+
+    int trained = 0;
+    int rounds = INT_MAX;
+    for (skill_type sk = SK_FIRST_SKILL; sk < NUM_SKILLS; ++sk)
+    {
+        if (!you.training[sk])
+            continue;
+        ++trained;
+        int inc = 1;
+        if (you.skill_manual_points[sk])
+        {
+            inc = 2;
+            rounds = min<int>(rounds, you.skill_manual_points[sk]);
+        }
+        const int left = (int) skill_exp_needed(MAX_SKILL_LEVEL, sk)
+                         - (int) you.skill_points[sk];
+        rounds = min(rounds, div_round_up(left, inc));
+    }
+    if (!trained)
+        return false;
+
+    const int round_cost = trained * point_cost;
+    rounds = min(rounds, you.exp_available / round_cost);
+    if (you.skill_cost_level < MAX_SKILL_COST_LEVEL)
+    {
+        // The last point has to be bought before the cost goes up.
+        const int room = skill_cost_needed(you.skill_cost_level + 1)
+                         - you.total_experience;
+        rounds = min(rounds, (room - 1 + point_cost) / round_cost);
+    }
+    if (rounds < 2)
+        return false;
+
+    for (skill_type sk = SK_FIRST_SKILL; sk < NUM_SKILLS; ++sk)
+    {
+        if (!you.training[sk])
+            continue;
+        const int bonus = you.skill_manual_points[sk] ? rounds : 0;
+        you.skill_manual_points[sk] -= bonus;
+        you.skill_points[sk] += rounds + bonus;
+    }
+    you.exp_available -= rounds * round_cost;
+    you.total_experience += rounds * round_cost;
+    check_skill_cost_change();
+    for (skill_type sk = SK_FIRST_SKILL; sk < NUM_SKILLS; ++sk)
+        if (you.training[sk])
+            _level_up_check(sk, true);
+    you.redraw_experience = true;
+    return true;
+}
+
 void change_skill_points(skill_type sk, int points, bool do_level_up)
 {
     if (static_cast<int>(you.skill_points[sk]) < -points)
@@ -1387,8 +1462,10 @@ static int _train(skill_type exsk, int &max_exp, bool simu)
         }
     }
 
-    const skill_type old_best_skill = best_skill(SK_FIRST_SKILL, SK_LAST_SKILL);
-    const int old_level = you.skill(exsk, 10, true);
+    // Only needed for redrawing, which simulations skip.
+    const skill_type old_best_skill =
+        simu ? SK_NONE : best_skill(SK_FIRST_SKILL, SK_LAST_SKILL);
+    const int old_level = simu ? 0 : you.skill(exsk, 10, true);
     you.skill_points[exsk] += skill_inc;
     you.exp_available -= cost;
     you.total_experience += cost;
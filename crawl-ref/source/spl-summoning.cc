@@ -2492,6 +2492,7 @@ static void _init_servitor_monster(monster &mon, const actor& caster)
     }
 
     mon.props[CUSTOM_SPELLS_KEY].get_bool() = true;
+    mon.info_changed();
 }
 
 void init_servitor(monster* servitor, actor* caster)
@@ -58,6 +58,7 @@
 #include "tileview.h"
 #include "viewchar.h"
 #include "view.h"
+#include "wiz-fsim.h"
 #ifdef USE_TILE_LOCAL
  #include "windowmanager.h"
 #endif
@@ -155,7 +156,13 @@ static void _initialize()
     you.game_seed = crawl_state.seed;
 
 #ifdef DEBUG_STATISTICS
-    if (crawl_state.map_stat_gen)
+    if (crawl_state.vault_test)
+    {
+        release_cli_signals();
+        mapstat_test_vaults();
+        end(0, false);
+    }
+    else if (crawl_state.map_stat_gen)
     {
         release_cli_signals();
         mapstat_generate_stats();
@@ -169,6 +176,21 @@ static void _initialize()
     }
 #endif
 
+    if (SysEnv.arena_batch_rounds)
+    {
+        release_cli_signals();
+        run_arena_batch(Options.game.arena_teams); // this is NORETURN
+    }
+
+#ifdef WIZARD
+    if (!SysEnv.fsim_combo.empty())
+    {
+        release_cli_signals();
+        wizard_fsim_batch(SysEnv.fsim_combo);
+        end(0, false);
+    }
+#endif
+
     if (!crawl_state.test_list)
     {
         if (!crawl_state.io_inited)
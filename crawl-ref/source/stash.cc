@@ -24,6 +24,7 @@
 #include "files.h"
 #include "feature.h"
 #include "god-passive.h"
+#include "hash.h"
 #include "hints.h"
 #include "invent.h"
 #include "item-prop.h"
@@ -53,6 +54,9 @@
 // Global
 StashTracker StashTrack;
 
+// Cached search text from an older epoch is rebuilt before it is used.
+static unsigned int search_text_epoch = 1;
+
 string userdef_annotate_item(const char *s, const item_def *item,
                              bool exclusive)
 {
@@ -170,7 +174,8 @@ static void _fully_identify_item(item_def *item)
 // Stash
 // ----------------------------------------------------------------------
 
-Stash::Stash(coord_def pos_) : items()
+Stash::Stash(coord_def pos_)
+    : items(), search_cache(), search_epoch(0), indexed(false)
 {
     // First, fix what square we're interested in
     if (pos_.origin())
@@ -234,12 +239,26 @@ static bool _grid_has_perceived_item(const coord_def& pos)
     return you.visible_igrd(pos) != NON_ITEM;
 }
 
+// Whether two item lists would be described and searched the same way.
+bool Stash::same_items(const vector<item_def> &a, const vector<item_def> &b)
+{
+    return a.size() == b.size()
+           && equal(a.begin(), a.end(), b.begin(),
+                    [](const item_def &x, const item_def &y)
+                    {
+                        return are_items_same(x, y, true)
+                               && x.inscription == y.inscription;
+                    });
+}
+
 bool Stash::unmark_trapping_nets()
 {
     bool changed = false;
     for (auto &item : items)
         if (item_is_stationary_net(item))
             item.net_placed = false, changed = true;
+    if (changed)
+        _items_changed();
     return changed;
 }
 
@@ -265,8 +284,14 @@ void Stash::update()
 
     // Players can now see every item in stacks in view
 
-    // Zap existing items
-    items.clear();
+    // Zap existing items, keeping their search text in case they turn out
+    // to be the same as before.
+    vector<item_def> old_items;
+    vector<search_text> old_cache;
+    old_items.swap(items);
+    old_cache.swap(search_cache);
+    const unsigned int old_epoch = search_epoch;
+    const bool old_indexed = indexed;
 
     // Now, grab all items on that square and fill our vector
     for (stack_iterator si(pos, true); si; ++si)
@@ -274,6 +299,15 @@ void Stash::update()
         god_id_item(*si);
         add_item(*si);
     }
+
+    if (same_items(old_items, items))
+    {
+        search_cache.swap(old_cache);
+        search_epoch = old_epoch;
+        indexed = old_indexed;
+    }
+    else
+        _items_changed();
     
     // make players still visit stacks; they might want to stop travel
     if (pos == you.pos())
@@ -364,16 +398,16 @@ vector<stash_search_result> Stash::matches_search(
     if (empty())
         return results;
 
-    for (const item_def &item : items)
+    const vector<search_text> &text = _search_text();
+    for (size_t i = 0; i < items.size(); ++i)
     {
-        const string s   = stash_item_name(item);
-        const string ann = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item);
-        if (search.matches(prefix + " " + ann + " " + s)
-            || is_dumpable_artefact(item) && search.matches(chardump_desc(item)))
+        const item_def &item = items[i];
+        if (search.matches(prefix + " " + text[i].annotated)
+            || text[i].is_artefact && search.matches(text[i].artefact))
         {
             stash_search_result res;
             res.match_type = MATCH_ITEM;
-            res.match = s;
+            res.match = text[i].name;
             res.primary_sort = item.name(DESC_QUALNAME);
             res.item = item;
             results.push_back(res);
@@ -400,6 +434,80 @@ vector<stash_search_result> Stash::matches_search(
     return results;
 }
 
+/**
+ * Build (if need be) the text each item is matched against when searching:
+ * the item names, search annotations and artefact descriptions. Working
+ * these out needs the item names and a Lua call per item, so they are kept
+ * until the items change or search_text_epoch moves on.
+ */
+const vector<Stash::search_text> &Stash::_search_text() const
+{
+    if (search_epoch == search_text_epoch
+        && search_cache.size() == items.size())
+    {
+        return search_cache;
+    }
+
+    if (search_epoch != search_text_epoch)
+        indexed = false;
+
+    search_cache.clear();
+    for (const item_def &item : items)
+    {
+        search_text text;
+        text.name = stash_item_name(item);
+        text.annotated = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item)
+                         + " " + text.name;
+        text.is_artefact = is_dumpable_artefact(item);
+        if (text.is_artefact)
+            text.artefact = chardump_desc(item);
+        search_cache.push_back(text);
+    }
+    search_epoch = search_text_epoch;
+    return search_cache;
+}
+
+// The items have changed: their search text has to be built again.
+void Stash::_items_changed()
+{
+    search_cache.clear();
+    search_epoch = 0;
+    indexed = false;
+}
+
+static void _add_trigrams(const string &text, vector<uint32_t> &grams)
+{
+    const string lower = lowercase_string(text);
+    for (size_t i = 0; i + 3 <= lower.size(); ++i)
+    {
+        grams.push_back((uint8_t) lower[i] << 16 | (uint8_t) lower[i + 1] << 8
+                        | (uint8_t) lower[i + 2]);
+    }
+}
+
+/**
+ * Every (lowercased) three character sequence of the text that
+ * matches_search() tests, for the level's search index.
+ *
+ * @param prefix The level's search prefix, as given to matches_search().
+ * @param grams  Set to the trigrams, sorted and without duplicates.
+ */
+void Stash::_search_trigrams(const string &prefix, vector<uint32_t> &grams) const
+{
+    grams.clear();
+    for (const search_text &text : _search_text())
+    {
+        _add_trigrams(prefix + " " + text.annotated, grams);
+        if (text.is_artefact)
+            _add_trigrams(text.artefact, grams);
+    }
+    if (feat != DNGN_FLOOR)
+        _add_trigrams(prefix + " " + feature_description(), grams);
+
+    sort(grams.begin(), grams.end());
+    grams.erase(unique(grams.begin(), grams.end()), grams.end());
+}
+
 /// Fedhas: rot away all corpses.
 void Stash::rot_all_corpses()
 {
@@ -407,7 +515,10 @@ void Stash::rot_all_corpses()
     {
         item_def &item = items[i];
         if (item.is_type(OBJ_CORPSES, CORPSE_BODY) && item.stash_freshness >= 0)
+        {
             item.stash_freshness = -1;
+            _items_changed();
+        }
     }
 }
 
@@ -425,8 +536,11 @@ void Stash::_update_corpses(int rot_time)
         if (new_rot <= _min_rot(item))
         {
             items.erase(items.begin() + i);
+            _items_changed();
             continue;
         }
+        if (item.stash_freshness != new_rot)
+            _items_changed();
         item.stash_freshness = static_cast<short>(new_rot);
     }
 }
@@ -435,8 +549,11 @@ void Stash::_update_identification()
 {
     for (int i = items.size() - 1; i >= 0; i--)
     {
+        const item_def old = items[i];
         god_id_item(items[i]);
         maybe_identify_base_type(items[i]);
+        if (items[i].flags != old.flags)
+            _items_changed();
     }
 }
 
@@ -449,6 +566,7 @@ void Stash::add_item(const item_def &item, bool add_to_front)
         items.insert(items.begin(), item);
     else
         items.push_back(item);
+    _items_changed();
 
     seen_item(item);
 
@@ -553,6 +671,7 @@ void Stash::load(reader& inf)
 
     // Zap out item vector, in case it's in use (however unlikely)
     items.clear();
+    _items_changed();
     // Read in the items
     for (int i = 0; i < count; ++i)
     {
@@ -681,7 +800,9 @@ void ShopInfo::write(FILE *f, bool identify) const
 LevelStashes::LevelStashes()
     : m_place(level_id::current()),
       m_stashes(),
-      m_shops()
+      m_shops(),
+      m_search_index(),
+      m_index_epoch(0)
 {
 }
 
@@ -776,14 +897,17 @@ void LevelStashes::move_stash(const coord_def& from, const coord_def& to)
 
     coord_def old_pos = s->pos;
     s->pos = to;
+    s->indexed = false;
     m_stashes[s->pos] = *s;
     m_stashes.erase(old_pos);
+    _invalidate_search_index();
 }
 
 // Removes a Stash from the level.
 void LevelStashes::kill_stash(const Stash &s)
 {
     m_stashes.erase(s.pos);
+    _invalidate_search_index();
 }
 
 void LevelStashes::add_stash(coord_def p)
@@ -857,10 +981,27 @@ void LevelStashes::get_matching_stashes(
         return;
     }
 
-    for (const auto &entry : m_stashes)
+    // Plain text can only be found in stashes which have all of its
+    // trigrams; anything else has to be tried on every stash.
+    vector<const Stash *> stashes;
+    auto plain = dynamic_cast<const plaintext_pattern *>(&search);
+    if (plain && s.size() >= 3)
+    {
+        if (!_search_index_valid())
+            _build_search_index(lplace);
+        for (const coord_def &c : _search_candidates(s))
+            stashes.push_back(&m_stashes.at(c));
+    }
+    else
+    {
+        for (const auto &entry : m_stashes)
+            stashes.push_back(&entry.second);
+    }
+
+    for (const Stash *stash : stashes)
     {
         vector<stash_search_result> new_results =
-            entry.second.matches_search(lplace, search);
+            stash->matches_search(lplace, search);
         for (auto &res : new_results)
         {
             res.pos.id = m_place;
@@ -880,6 +1021,77 @@ void LevelStashes::get_matching_stashes(
     }
 }
 
+// Is the index still made from the search text of every stash on the level?
+bool LevelStashes::_search_index_valid() const
+{
+    if (m_index_epoch != search_text_epoch)
+        return false;
+    for (const auto &entry : m_stashes)
+        if (!entry.second.indexed)
+            return false;
+    return true;
+}
+
+// A stash has gone: the index may still list where it was.
+void LevelStashes::_invalidate_search_index()
+{
+    m_search_index.clear();
+    m_index_epoch = 0;
+}
+
+void LevelStashes::_build_search_index(const string &prefix) const
+{
+    m_search_index.clear();
+    vector<uint32_t> grams;
+    for (const auto &entry : m_stashes)
+    {
+        entry.second._search_trigrams(prefix, grams);
+        for (uint32_t gram : grams)
+            m_search_index[gram].push_back(entry.first);
+        entry.second.indexed = true;
+    }
+    m_index_epoch = search_text_epoch;
+}
+
+/**
+ * Find the stashes which might contain some text, without matching it
+ * against each of them.
+ *
+ * @param text Text at least three characters long.
+ * @return The stashes with all the trigrams of the text, in map order.
+ */
+vector<coord_def> LevelStashes::_search_candidates(const string &text) const
+{
+    vector<uint32_t> grams;
+    _add_trigrams(text, grams);
+    sort(grams.begin(), grams.end());
+    grams.erase(unique(grams.begin(), grams.end()), grams.end());
+
+    vector<const vector<coord_def> *> lists;
+    for (uint32_t gram : grams)
+    {
+        auto list = map_find(m_search_index, gram);
+        if (!list)
+            return {};
+        lists.push_back(list);
+    }
+    sort(lists.begin(), lists.end(),
+         [](const vector<coord_def> *a, const vector<coord_def> *b)
+         { return a->size() < b->size(); });
+
+    vector<coord_def> candidates;
+    for (const coord_def &c : *lists[0])
+    {
+        if (all_of(lists.begin() + 1, lists.end(),
+                   [&c](const vector<coord_def> *list)
+                   { return binary_search(list->begin(), list->end(), c); }))
+        {
+            candidates.push_back(c);
+        }
+    }
+    return candidates;
+}
+
 /// Fedhas: rot away all corpses.
 void LevelStashes::rot_all_corpses()
 {
@@ -1344,12 +1556,35 @@ static vector<stash_search_result> _stash_filter_duplicates(vector<stash_search_
     return out;
 }
 
+// Work out whether anything the search text of stashes depends on, other
+// than the items themselves, has changed since the last search.
+static void _check_search_context()
+{
+    typedef tuple<uint32_t, uint32_t, god_type, transformation, species_type,
+                  int, int, int> search_context;
+    static search_context last_context;
+
+    // Search annotations come from Lua in the options, so any options
+    // change counts.
+    const search_context context(
+        hash32(&you.type_ids, sizeof(you.type_ids)),
+        hash32(&you.force_autopickup, sizeof(you.force_autopickup)),
+        you.religion, you.form, you.species, you.experience_level,
+        Options.autopickup_on, Options.generation);
+    if (context != last_context)
+    {
+        last_context = context;
+        StashTrack.search_text_changed();
+    }
+}
+
 void StashTracker::search_stashes(string search_term)
 {
     char buf[400];
 
     update_corpses();
     update_identification();
+    _check_search_context();
 
     if (search_term.empty())
     {
@@ -1488,6 +1723,14 @@ void StashTracker::search_stashes(string search_term)
     }
 }
 
+// How many search results plain text gets on this level. Used by tests.
+int StashTracker::count_matches_here(const string &text) const
+{
+    vector<stash_search_result> results;
+    get_matching_stashes(plaintext_pattern(text, true), results, true);
+    return results.size();
+}
+
 void StashTracker::get_matching_stashes(
         const base_pattern &search,
         vector<stash_search_result> &results,
@@ -1751,6 +1994,12 @@ void StashTracker::update_corpses()
         entry.second._update_corpses(rot_time);
 }
 
+/// Throw away the cached search text of every stash.
+void StashTracker::search_text_changed()
+{
+    ++search_text_epoch;
+}
+
 void StashTracker::update_identification()
 {
     if (!have_passive(passive_t::identify_items))
@@ -64,9 +64,21 @@ public:
     bool is_verified() const {  return verified; }
 
 private:
+    // What searches are matched against for one item.
+    struct search_text
+    {
+        string name;        // stash_item_name()
+        string annotated;   // search annotations followed by the name
+        string artefact;    // chardump_desc(), if is_dumpable_artefact()
+        bool is_artefact;
+    };
+
     void _update_corpses(int rot_time);
     void _update_identification();
     void add_item(const item_def &item, bool add_to_front = false);
+    void _items_changed();
+    const vector<search_text> &_search_text() const;
+    void _search_trigrams(const string &prefix, vector<uint32_t> &grams) const;
 
 private:
     bool verified;      // Is this correct to the best of our knowledge?
@@ -77,8 +89,17 @@ private:
 
     vector<item_def> items;
 
+    // Search text of the items, built when first searched and kept until the
+    // items or anything else the text depends on changes.
+    mutable vector<search_text> search_cache;
+    mutable unsigned int search_epoch;
+    // Is this stash in its level's search index as it is now?
+    mutable bool indexed;
+
     static bool are_items_same(const item_def &, const item_def &,
                                bool exact = false);
+    static bool same_items(const vector<item_def> &a,
+                           const vector<item_def> &b);
 
     friend class LevelStashes;
     friend class ST_ItemIterator;
@@ -220,6 +241,10 @@ private:
     void _update_corpses(int rot_time);
     void _update_identification();
     void _waypoint_search(int n, vector<stash_search_result> &results) const;
+    bool _search_index_valid() const;
+    void _invalidate_search_index();
+    void _build_search_index(const string &prefix) const;
+    vector<coord_def> _search_candidates(const string &text) const;
 
     typedef map<coord_def, Stash> stashes_t;
     typedef vector<ShopInfo> shops_t;
@@ -229,6 +254,10 @@ private:
     stashes_t m_stashes;
     shops_t m_shops;
 
+    // The stashes whose search text contains each trigram, in map order.
+    mutable map<uint32_t, vector<coord_def>> m_search_index;
+    mutable unsigned int m_index_epoch;
+
     friend class StashTracker;
     friend class ST_ItemIterator;
 };
@@ -241,6 +270,8 @@ public:
     }
 
     void search_stashes(string search_term = "");
+    int count_matches_here(const string &text) const;
+    void search_text_changed();
 
     LevelStashes &get_current_level();
     LevelStashes *find_current_level();
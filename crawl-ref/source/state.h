@@ -62,6 +62,7 @@ struct game_state
     bool map_stat_dump_disconnect; // Set if we dump disconnected maps and exit
                                    // under mapstat.
     bool obj_stat_gen;      // Set if we're generating object stats.
+    bool vault_test;        // Set if we're test-placing vaults.
 
     string force_map;       // Set if we're forcing a specific map to generate.
 
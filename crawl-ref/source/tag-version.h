@@ -230,6 +230,9 @@ enum tag_minor_version
     TAG_MINOR_REMOVE_DECKS,        // Decks are no more
     TAG_MINOR_GAMESEEDS,           // Game seeds + rng state saved
     TAG_MINOR_GOLDIFY_MANUALS,     // Move manuals out of the inventory
+    TAG_MINOR_LEVEL_SECTIONS,      // Save levels as one chunk per section
+    TAG_MINOR_MAP_CELL_RUNS,       // Run-length map knowledge, varint pgrid
+    TAG_MINOR_LEVEL_MAP_SECTIONS,  // Level state and map out of the grids
 #endif
     NUM_TAG_MINORS,
     TAG_MINOR_VERSION = NUM_TAG_MINORS - 1
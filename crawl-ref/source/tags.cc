@@ -227,7 +227,7 @@ void reader::fail_if_not_eof(const string &name)
     char dummy;
     if (_chunk ? _chunk->read(&dummy, 1) :
         _file ? (fgetc(_file) != EOF) :
-        _read_offset >= _pbuf->size())
+        _read_offset < _pbuf->size())
     {
         fail("Incomplete read of \"%s\" - aborting.", name.c_str());
     }
@@ -306,10 +306,12 @@ static void tag_read_lost_items(reader &th);
 static void tag_read_companions(reader &th);
 
 static void tag_construct_level(writer &th);
+static void tag_construct_level_grids(writer &th);
+static void tag_construct_level_map(writer &th);
 static void tag_construct_level_items(writer &th);
 static void tag_construct_level_monsters(writer &th);
 static void tag_construct_level_tiles(writer &th);
-static void tag_read_level(reader &th);
+static void tag_read_level(reader &th, reader &grids, reader &map);
 static void tag_read_level_items(reader &th);
 static void tag_read_level_monsters(reader &th);
 static void tag_read_level_tiles(reader &th);
@@ -333,6 +335,8 @@ static void marshallMonsterInfo (writer &, const monster_info &);
 static void unmarshallMonsterInfo (reader &, monster_info &mi);
 static void marshallMapCell (writer &, const map_cell &);
 static void unmarshallMapCell (reader &, map_cell& cell);
+static void _marshall_map_knowledge(writer &th, const MapKnowledge &mk);
+static void _unmarshall_map_knowledge(reader &th, MapKnowledge &mk);
 
 template<typename T, typename T_iter, typename T_marshal>
 static void marshall_iterator(writer &th, T_iter beg, T_iter end,
@@ -1167,15 +1171,6 @@ void tag_write(tag_type tagID, writer &outf)
         CANARY;
         tag_construct_companions(th);
         break;
-    case TAG_LEVEL:
-        tag_construct_level(th);
-        CANARY;
-        tag_construct_level_items(th);
-        CANARY;
-        tag_construct_level_monsters(th);
-        CANARY;
-        tag_construct_level_tiles(th);
-        break;
     case TAG_GHOST:
         tag_construct_ghost(th, global_ghosts);
         break;
@@ -1227,6 +1222,71 @@ static void _shunt_monsters_out_of_walls()
 // Read a piece of data from inf into memory, then run the appropriate reader.
 //
 // minorVersion is available for any sub-readers that need it
+static void _eat_canary(reader &th)
+{
+    EAT_CANARY;
+}
+
+// The parts of a level may come from one reader (a whole TAG_LEVEL chunk)
+// or from one reader each (a level saved in sections).
+static void _tag_read_level_parts(reader &state, reader &grids, reader &map,
+                                  reader &items, reader &mons, reader &tiles)
+{
+    tag_read_level(state, grids, map);
+    _eat_canary(state);
+    tag_read_level_items(items);
+    // We have to do this here because tag_read_level_monsters()
+    // might kill an elsewhere Ilsuiw follower, which ends up calling
+    // terrain.cc:_dgn_check_terrain_items, which checks mitm.
+    link_items();
+    _eat_canary(items);
+    tag_read_level_monsters(mons);
+    _eat_canary(mons);
+#if TAG_MAJOR_VERSION == 34
+    _add_missing_branches();
+#endif
+    _shunt_monsters_out_of_walls();
+    // The Abyss needs to visit other levels during level gen, before
+    // all cells have been filled. We mustn't crash when it returns
+    // from those excursions, and generate_abyss will check_map_validity
+    // itself after the grid is fully populated.
+    if (!player_in_branch(BRANCH_ABYSS))
+    {
+        unwind_var<coord_def> you_pos(you.position, coord_def());
+        check_map_validity();
+    }
+    tag_read_level_tiles(tiles);
+#if TAG_MAJOR_VERSION == 34
+    if (you.where_are_you == BRANCH_GAUNTLET
+        && grids.getMinorVersion() < TAG_MINOR_GAUNTLET_TRAPPED)
+    {
+        vault_placement *place = dgn_vault_at(you.pos());
+        if (place && place->map.desc_or_name()
+                     == "gammafunk_gauntlet_branching")
+        {
+            auto exit = DNGN_EXIT_GAUNTLET;
+            grd(you.pos()) = exit;
+            // Announce the repair even in non-debug builds.
+            mprf(MSGCH_ERROR, "Placing emergency exit: %s.",
+                 dungeon_feature_name(exit));
+        }
+    }
+
+    // We can't do this when we unmarshall shops, since we haven't
+    // unmarshalled items yet...
+    if (grids.getMinorVersion() < TAG_MINOR_SHOP_HACK)
+        for (auto& entry : env.shop)
+        {
+            // Shop items were heaped up at this cell.
+            for (stack_iterator si(coord_def(0, entry.second.num+5)); si; ++si)
+            {
+                entry.second.stock.push_back(*si);
+                dec_mitm_item_quantity(si.index(), si->quantity);
+            }
+        }
+#endif
+}
+
 void tag_read(reader &inf, tag_type tag_id)
 {
     // Read header info and data
@@ -1268,59 +1328,7 @@ void tag_read(reader &inf, tag_type tag_id)
         check_selected_skills();
         break;
     case TAG_LEVEL:
-        tag_read_level(th);
-        EAT_CANARY;
-        tag_read_level_items(th);
-        // We have to do this here because tag_read_level_monsters()
-        // might kill an elsewhere Ilsuiw follower, which ends up calling
-        // terrain.cc:_dgn_check_terrain_items, which checks mitm.
-        link_items();
-        EAT_CANARY;
-        tag_read_level_monsters(th);
-        EAT_CANARY;
-#if TAG_MAJOR_VERSION == 34
-        _add_missing_branches();
-#endif
-        _shunt_monsters_out_of_walls();
-        // The Abyss needs to visit other levels during level gen, before
-        // all cells have been filled. We mustn't crash when it returns
-        // from those excursions, and generate_abyss will check_map_validity
-        // itself after the grid is fully populated.
-        if (!player_in_branch(BRANCH_ABYSS))
-        {
-            unwind_var<coord_def> you_pos(you.position, coord_def());
-            check_map_validity();
-        }
-        tag_read_level_tiles(th);
-#if TAG_MAJOR_VERSION == 34
-        if (you.where_are_you == BRANCH_GAUNTLET
-            && th.getMinorVersion() < TAG_MINOR_GAUNTLET_TRAPPED)
-        {
-            vault_placement *place = dgn_vault_at(you.pos());
-            if (place && place->map.desc_or_name()
-                         == "gammafunk_gauntlet_branching")
-            {
-                auto exit = DNGN_EXIT_GAUNTLET;
-                grd(you.pos()) = exit;
-                // Announce the repair even in non-debug builds.
-                mprf(MSGCH_ERROR, "Placing emergency exit: %s.",
-                     dungeon_feature_name(exit));
-            }
-        }
-
-        // We can't do this when we unmarshall shops, since we haven't
-        // unmarshalled items yet...
-        if (th.getMinorVersion() < TAG_MINOR_SHOP_HACK)
-            for (auto& entry : env.shop)
-            {
-                // Shop items were heaped up at this cell.
-                for (stack_iterator si(coord_def(0, entry.second.num+5)); si; ++si)
-                {
-                    entry.second.stock.push_back(*si);
-                    dec_mitm_item_quantity(si.index(), si->quantity);
-                }
-            }
-#endif
+        _tag_read_level_parts(th, th, th, th, th, th);
         break;
     case TAG_GHOST:
         global_ghosts = tag_read_ghost(th);
@@ -1331,6 +1339,93 @@ void tag_read(reader &inf, tag_type tag_id)
     }
 }
 
+/**
+ * Serialise the current level as separate sections, so that the caller can
+ * store each one as its own chunk and skip those that did not change.
+ *
+ * @param sections Set to one buffer per level_section_type; those not
+ *                 wanted are left empty.
+ * @param wanted   Which sections to serialise.
+ */
+void tag_write_level_sections(vector<vector<unsigned char>> &sections,
+                              const FixedBitVector<NUM_LEVEL_SECTIONS> &wanted)
+{
+    sections.assign(NUM_LEVEL_SECTIONS, vector<unsigned char>());
+
+    if (wanted[LEVEL_SECTION_STATE])
+    {
+        writer state(&sections[LEVEL_SECTION_STATE]);
+        tag_construct_level(state);
+        marshallUByte(state, 171);
+    }
+
+    if (wanted[LEVEL_SECTION_GRIDS])
+    {
+        writer grids(&sections[LEVEL_SECTION_GRIDS]);
+        tag_construct_level_grids(grids);
+    }
+
+    if (wanted[LEVEL_SECTION_MAP])
+    {
+        writer map(&sections[LEVEL_SECTION_MAP]);
+        tag_construct_level_map(map);
+    }
+
+    if (wanted[LEVEL_SECTION_ITEMS])
+    {
+        writer items(&sections[LEVEL_SECTION_ITEMS]);
+        tag_construct_level_items(items);
+        marshallUByte(items, 171);
+    }
+
+    if (wanted[LEVEL_SECTION_MONSTERS])
+    {
+        writer mons(&sections[LEVEL_SECTION_MONSTERS]);
+        tag_construct_level_monsters(mons);
+        marshallUByte(mons, 171);
+    }
+
+    if (wanted[LEVEL_SECTION_TILES])
+    {
+        writer tiles(&sections[LEVEL_SECTION_TILES]);
+        tag_construct_level_tiles(tiles);
+    }
+}
+
+/**
+ * Load the current level from the sections written by
+ * tag_write_level_sections().
+ *
+ * @param sections     One buffer per level_section_type.
+ * @param minorVersion The minor version the sections were saved with.
+ */
+void tag_read_level_sections(const vector<vector<unsigned char>> &sections,
+                             int minorVersion)
+{
+    ASSERT(sections.size() == NUM_LEVEL_SECTIONS);
+    reader state(sections[LEVEL_SECTION_STATE], minorVersion);
+    reader grids(sections[LEVEL_SECTION_GRIDS], minorVersion);
+    reader map(sections[LEVEL_SECTION_MAP], minorVersion);
+    reader items(sections[LEVEL_SECTION_ITEMS], minorVersion);
+    reader mons(sections[LEVEL_SECTION_MONSTERS], minorVersion);
+    reader tiles(sections[LEVEL_SECTION_TILES], minorVersion);
+
+#if TAG_MAJOR_VERSION == 34
+    // The level state and map knowledge used to be part of the grids.
+    if (minorVersion < TAG_MINOR_LEVEL_MAP_SECTIONS)
+        _tag_read_level_parts(grids, grids, grids, items, mons, tiles);
+    else
+#endif
+    _tag_read_level_parts(state, grids, map, items, mons, tiles);
+
+    state.fail_if_not_eof("level state");
+    grids.fail_if_not_eof("level grids");
+    map.fail_if_not_eof("level map");
+    items.fail_if_not_eof("level items");
+    mons.fail_if_not_eof("level monsters");
+    tiles.fail_if_not_eof("level tiles");
+}
+
 static void tag_construct_char(writer &th)
 {
     marshallByte(th, TAG_CHR_FORMAT);
@@ -4304,24 +4399,6 @@ static void tag_construct_level(writer &th)
 
     CANARY;
 
-    for (int count_x = 0; count_x < GXM; count_x++)
-        for (int count_y = 0; count_y < GYM; count_y++)
-        {
-            marshallByte(th, grd[count_x][count_y]);
-            marshallMapCell(th, env.map_knowledge[count_x][count_y]);
-            marshallInt(th, env.pgrid[count_x][count_y].flags);
-        }
-
-    marshallBoolean(th, !!env.map_forgotten);
-    if (env.map_forgotten)
-        for (int x = 0; x < GXM; x++)
-            for (int y = 0; y < GYM; y++)
-                marshallMapCell(th, (*env.map_forgotten)[x][y]);
-
-    _run_length_encode(th, marshallByte, env.grid_colours, GXM, GYM);
-
-    CANARY;
-
     // how many clouds?
     marshallShort(th, env.cloud.size());
     for (const auto& entry : env.cloud)
@@ -4361,15 +4438,6 @@ static void tag_construct_level(writer &th)
     // be saved if they're complete? TODO: logic is kind of weird.
     marshallInt(th, you.dactions.size());
 
-    // Save heightmap, if present.
-    marshallByte(th, !!env.heightmap);
-    if (env.heightmap)
-    {
-        grid_heightmap &heightmap(*env.heightmap);
-        for (rectangle_iterator ri(0); ri; ++ri)
-            marshallShort(th, heightmap(*ri));
-    }
-
     CANARY;
 
     marshallInt(th, env.forest_awoken_until);
@@ -4384,6 +4452,41 @@ static void tag_construct_level(writer &th)
     }
 }
 
+// The terrain of the level, which tag_read_level() reads from its grids
+// reader.
+static void tag_construct_level_grids(writer &th)
+{
+    for (int count_x = 0; count_x < GXM; count_x++)
+        for (int count_y = 0; count_y < GYM; count_y++)
+        {
+            marshallByte(th, grd[count_x][count_y]);
+            marshallUnsigned(th, env.pgrid[count_x][count_y].flags);
+        }
+
+    _run_length_encode(th, marshallByte, env.grid_colours, GXM, GYM);
+
+    CANARY;
+
+    // Save heightmap, if present.
+    marshallByte(th, !!env.heightmap);
+    if (env.heightmap)
+    {
+        grid_heightmap &heightmap(*env.heightmap);
+        for (rectangle_iterator ri(0); ri; ++ri)
+            marshallShort(th, heightmap(*ri));
+    }
+}
+
+// The player's map of the level, which tag_read_level() reads from its map
+// reader.
+static void tag_construct_level_map(writer &th)
+{
+    _marshall_map_knowledge(th, env.map_knowledge);
+    marshallBoolean(th, !!env.map_forgotten);
+    if (env.map_forgotten)
+        _marshall_map_knowledge(th, *env.map_forgotten);
+}
+
 void marshallItem(writer &th, const item_def &item, bool iinfo)
 {
     marshallByte(th, item.base_type);
@@ -5141,6 +5244,42 @@ void unmarshallMapCell(reader &th, map_cell& cell)
     cell.flags = cell_flags;
 }
 
+// A grid of map knowledge is written column by column. Each cell is
+// preceded by how many times it repeats: long stretches of unseen or plain
+// explored cells are written only once. Cells that know of a cloud, item or
+// monster never compare equal to another, so they always have a count of 1.
+static void _marshall_map_knowledge(writer &th, const MapKnowledge &mk)
+{
+    const int end = GXM * GYM;
+    for (int i = 0; i < end;)
+    {
+        const map_cell &cell = mk.cell(i / GYM, i % GYM);
+        int run = 1;
+        while (i + run < end && mk.cell((i + run) / GYM, (i + run) % GYM) == cell)
+            ++run;
+
+        marshallUnsigned(th, run);
+        marshallMapCell(th, cell);
+        i += run;
+    }
+}
+
+static void _unmarshall_map_knowledge(reader &th, MapKnowledge &mk)
+{
+    const int end = GXM * GYM;
+    for (int i = 0; i < end;)
+    {
+        const int run = unmarshallUnsigned(th);
+        ASSERT(run > 0 && i + run <= end);
+
+        map_cell &cell = mk.cell(i / GYM, i % GYM);
+        unmarshallMapCell(th, cell);
+        for (int j = 1; j < run; ++j)
+            mk.cell((i + j) / GYM, (i + j) % GYM) = cell;
+        i += run;
+    }
+}
+
 static void tag_construct_level_items(writer &th)
 {
     // how many traps?
@@ -5722,7 +5861,9 @@ void tag_construct_level_tiles(writer &th)
     marshallInt(th, TILE_WALL_MAX);
 }
 
-static void tag_read_level(reader &th)
+// The terrain and the map knowledge come from their own readers, which are
+// all the same one for a level saved before they had sections of their own.
+static void tag_read_level(reader &th, reader &grids, reader &map)
 {
     env.floor_colour = unmarshallUByte(th);
     env.rock_colour  = unmarshallUByte(th);
@@ -5755,7 +5896,7 @@ static void tag_read_level(reader &th)
     for (int i = 0; i < gx; i++)
         for (int j = 0; j < gy; j++)
         {
-            dungeon_feature_type feat = unmarshallFeatureType(th);
+            dungeon_feature_type feat = unmarshallFeatureType(grids);
             grd[i][j] = feat;
             ASSERT(feat < NUM_FEATURES);
 
@@ -5763,20 +5904,37 @@ static void tag_read_level(reader &th)
             // Save these for potential destination clean up.
             if (grd[i][j] == DNGN_TRANSPORTER)
                 transporters.push_back(coord_def(i, j));
+
+            if (th.getMinorVersion() < TAG_MINOR_MAP_CELL_RUNS)
+            {
+                unmarshallMapCell(map, env.map_knowledge.cell(i, j));
+                env.pgrid[i][j].flags = unmarshallInt(grids);
+            }
+            else
+#endif
+            env.pgrid[i][j].flags = unmarshallUnsigned(grids);
+
+            mgrd[i][j] = NON_MONSTER;
+        }
+
+#if TAG_MAJOR_VERSION == 34
+    if (th.getMinorVersion() >= TAG_MINOR_MAP_CELL_RUNS)
 #endif
-            unmarshallMapCell(th, env.map_knowledge[i][j]);
+    _unmarshall_map_knowledge(map, env.map_knowledge);
+
+    for (int i = 0; i < gx; i++)
+        for (int j = 0; j < gy; j++)
+        {
+            map_cell &cell = env.map_knowledge.cell(i, j);
             // Fixup positions
-            if (env.map_knowledge[i][j].monsterinfo())
-                env.map_knowledge[i][j].monsterinfo()->pos = coord_def(i, j);
-            if (env.map_knowledge[i][j].cloudinfo())
-                env.map_knowledge[i][j].cloudinfo()->pos = coord_def(i, j);
+            if (cell.monsterinfo())
+                cell.monsterinfo()->pos = coord_def(i, j);
+            if (cell.cloudinfo())
+                cell.cloudinfo()->pos = coord_def(i, j);
 
-            env.map_knowledge[i][j].flags &= ~MAP_VISIBLE_FLAG;
-            if (env.map_knowledge[i][j].seen())
+            cell.flags &= ~MAP_VISIBLE_FLAG;
+            if (cell.seen())
                 env.map_seen.set(i, j);
-            env.pgrid[i][j].flags = unmarshallInt(th);
-
-            mgrd[i][j] = NON_MONSTER;
         }
 
 #if TAG_MAJOR_VERSION == 34
@@ -5784,21 +5942,28 @@ static void tag_read_level(reader &th)
         env.map_forgotten.reset();
     else
 #endif
-    if (unmarshallBoolean(th))
+    if (unmarshallBoolean(map))
     {
         MapKnowledge *f = new MapKnowledge();
-        for (int x = 0; x < GXM; x++)
-            for (int y = 0; y < GYM; y++)
-                unmarshallMapCell(th, (*f)[x][y]);
+#if TAG_MAJOR_VERSION == 34
+        if (th.getMinorVersion() < TAG_MINOR_MAP_CELL_RUNS)
+        {
+            for (int x = 0; x < GXM; x++)
+                for (int y = 0; y < GYM; y++)
+                    unmarshallMapCell(map, f->cell(x, y));
+        }
+        else
+#endif
+        _unmarshall_map_knowledge(map, *f);
         env.map_forgotten.reset(f);
     }
     else
         env.map_forgotten.reset();
 
     env.grid_colours.init(BLACK);
-    _run_length_decode(th, unmarshallByte, env.grid_colours, GXM, GYM);
+    _run_length_decode(grids, unmarshallByte, env.grid_colours, GXM, GYM);
 
-    EAT_CANARY;
+    _eat_canary(grids);
 
     env.cloud.clear();
     // how many clouds?
@@ -5921,13 +6086,13 @@ static void tag_read_level(reader &th)
 
     // Restore heightmap
     env.heightmap.reset(nullptr);
-    const bool have_heightmap = unmarshallBoolean(th);
+    const bool have_heightmap = unmarshallBoolean(grids);
     if (have_heightmap)
     {
         env.heightmap.reset(new grid_heightmap);
         grid_heightmap &heightmap(*env.heightmap);
         for (rectangle_iterator ri(0); ri; ++ri)
-            heightmap(*ri) = unmarshallShort(th);
+            heightmap(*ri) = unmarshallShort(grids);
     }
 
     EAT_CANARY;
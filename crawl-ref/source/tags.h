@@ -7,6 +7,7 @@
 
 #include <cstdio>
 
+#include "bitary.h"
 #include "package.h"
 
 struct show_type;
@@ -28,6 +29,20 @@ enum tag_type   // used during save/load process to identify data blocks
     TAG_SKIP
 };
 
+// The parts of TAG_LEVEL, when a level is saved as one chunk per part.
+// Levels saved before TAG_MINOR_LEVEL_MAP_SECTIONS only have the first four,
+// with the state and the map knowledge in the grids.
+enum level_section_type
+{
+    LEVEL_SECTION_GRIDS,
+    LEVEL_SECTION_ITEMS,
+    LEVEL_SECTION_MONSTERS,
+    LEVEL_SECTION_TILES,
+    LEVEL_SECTION_MAP,
+    LEVEL_SECTION_STATE,
+    NUM_LEVEL_SECTIONS
+};
+
 /* ***********************************************************************
  * writer API
  * *********************************************************************** */
@@ -170,6 +185,10 @@ static inline void unmarshallSigned(reader& th, T& v)
 void tag_read(reader &inf, tag_type tag_id);
 void tag_write(tag_type tagID, writer &outf);
 void tag_read_char(reader &th, uint8_t format, uint8_t major, uint8_t minor);
+void tag_write_level_sections(vector<vector<unsigned char>> &sections,
+                              const FixedBitVector<NUM_LEVEL_SECTIONS> &wanted);
+void tag_read_level_sections(const vector<vector<unsigned char>> &sections,
+                             int minorVersion);
 
 vector<ghost_demon> tag_read_ghosts(reader &th);
 void tag_write_ghosts(writer &th, const vector<ghost_demon> &ghosts);
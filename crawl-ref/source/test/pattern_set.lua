@@ -0,0 +1,27 @@
+-----------------------------------------------------------------------
+-- Tests that option pattern lists find the same first match as trying
+-- each pattern in turn.
+-----------------------------------------------------------------------
+
+local function same(text, ...)
+  local set, serial = debug.first_pattern_match(text, ...)
+  assert(set == serial,
+         "'" .. text .. "': pattern set found " .. set
+         .. ", one by one found " .. serial)
+  return set
+end
+
+for _, text in ipairs({ "the foo bar", "a foobar", "<foo>", "foo" }) do
+  same(text, "\\<foo\\>")
+  same(text, "\\bfoo\\b")
+  same(text, "zzz", "\\<foo\\>", "foo")
+end
+
+for _, text in ipairs({ "A", "x41", "41", "an Axe" }) do
+  same(text, "\\x41")
+  same(text, "\\x41xe", "axe")
+end
+
+assert(same("the foo bar", "\\bfoo\\b") == 1)
+assert(same("a foobar", "\\bfoo\\b") == 0)
+assert(same("foo bar", "zzz", "bar") == 2)
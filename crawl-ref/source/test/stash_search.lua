@@ -0,0 +1,37 @@
+-----------------------------------------------------------------------
+-- Tests that stash searches keep working as stashes come and go.
+-----------------------------------------------------------------------
+
+local p1 = dgn.point(20, 20)
+local p2 = dgn.point(30, 20)
+
+debug.goto_place("D:2")
+dgn.reset_level()
+dgn.fill_grd_area(1, 1, dgn.GXM - 2, dgn.GYM - 2, 'floor')
+
+local function place(p, item)
+  dgn.create_item(p.x, p.y, item)
+  debug.add_stash(p.x, p.y)
+end
+
+local function matches(text, expected)
+  local found = debug.stash_search(text)
+  assert(found == expected,
+         "Search for '" .. text .. "' found " .. found .. " stashes, expected "
+         .. expected)
+end
+
+place(p1, "long sword")
+place(p2, "long sword")
+matches("long sword", 2)
+
+-- Searching builds the index; the stash at p1 then goes away.
+for _, item in ipairs(dgn.items_at(p1.x, p1.y)) do
+  item.destroy()
+end
+debug.add_stash(p1.x, p1.y)
+matches("long sword", 1)
+
+-- A stash updated with the same items is still found.
+debug.add_stash(p2.x, p2.y)
+matches("long sword", 1)
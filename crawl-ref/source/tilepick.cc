@@ -2,6 +2,8 @@
 
 #include "tilepick.h"
 
+#include <chrono>
+
 #include "artefact.h"
 #include "art-enum.h"
 #include "cloud.h"
@@ -142,7 +144,24 @@ tileidx_t tileidx_shop(const shop_struct *shop)
     }
 }
 
-tileidx_t tileidx_feature_base(dungeon_feature_type feat)
+// Features whose tile depends on where the player is or has been. Any new
+// case like that in _tileidx_feature_base() has to be listed here.
+static bool _feature_tile_varies(dungeon_feature_type feat)
+{
+    switch (feat)
+    {
+    case DNGN_TREE:
+    case DNGN_ENTER_HELL:
+    case DNGN_STONE_ARCH:
+    case DNGN_ENTER_VAULTS:
+    case DNGN_ENTER_ZOT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static tileidx_t _tileidx_feature_base(dungeon_feature_type feat)
 {
     switch (feat)
     {
@@ -478,6 +497,33 @@ tileidx_t tileidx_feature_base(dungeon_feature_type feat)
     }
 }
 
+// The tiles of all features that always look the same, indexed by feature;
+// TILE_FEAT_MAX for those that don't.
+static struct feature_tile_table
+{
+    tileidx_t tiles[NUM_FEATURES];
+
+    feature_tile_table()
+    {
+        for (int i = 0; i < NUM_FEATURES; ++i)
+        {
+            const dungeon_feature_type feat = dungeon_feature_type(i);
+            tiles[i] = _feature_tile_varies(feat) ? TILE_FEAT_MAX
+                                                  : _tileidx_feature_base(feat);
+        }
+    }
+} _feature_tiles;
+
+tileidx_t tileidx_feature_base(dungeon_feature_type feat)
+{
+    if (static_cast<unsigned int>(feat) < NUM_FEATURES
+        && _feature_tiles.tiles[feat] != TILE_FEAT_MAX)
+    {
+        return _feature_tiles.tiles[feat];
+    }
+    return _tileidx_feature_base(feat);
+}
+
 bool is_door_tile(tileidx_t tile)
 {
     return tile >= TILE_DNGN_CLOSED_DOOR &&
@@ -486,7 +532,7 @@ bool is_door_tile(tileidx_t tile)
 
 tileidx_t tileidx_feature(const coord_def &gc)
 {
-    dungeon_feature_type feat = env.map_knowledge(gc).feat();
+    dungeon_feature_type feat = env.map_knowledge.get(gc).feat();
 
     tileidx_t override = env.tile_flv(gc).feat;
     bool can_override = !feat_is_door(feat)
@@ -530,7 +576,7 @@ tileidx_t tileidx_feature(const coord_def &gc)
     case DNGN_PERMAROCK_WALL:
     case DNGN_CLEAR_PERMAROCK_WALL:
     {
-        unsigned colour = env.map_knowledge(gc).feat_colour();
+        unsigned colour = env.map_knowledge.get(gc).feat_colour();
         if (colour == 0)
         {
             colour = feat == DNGN_FLOOR     ? env.floor_colour :
@@ -558,7 +604,7 @@ tileidx_t tileidx_feature(const coord_def &gc)
 
     case DNGN_TRAP_MECHANICAL:
     case DNGN_TRAP_TELEPORT:
-        return _tileidx_trap(env.map_knowledge(gc).trap());
+        return _tileidx_trap(env.map_knowledge.get(gc).trap());
 
     case DNGN_TRAP_WEB:
     {
@@ -577,8 +623,8 @@ tileidx_t tileidx_feature(const coord_def &gc)
         };
         int solid = 0;
         for (int i = 0; i < 4; i++)
-            if (feat_is_solid(env.map_knowledge(neigh[i]).feat())
-                || env.map_knowledge(neigh[i]).trap() == TRAP_WEB)
+            if (feat_is_solid(env.map_knowledge.get(neigh[i]).feat())
+                || env.map_knowledge.get(neigh[i]).trap() == TRAP_WEB)
             {
                 solid |= 1 << i;
             }
@@ -590,8 +636,8 @@ tileidx_t tileidx_feature(const coord_def &gc)
         return tileidx_shop(shop_at(gc));
 
     case DNGN_DEEP_WATER:
-        if (env.map_knowledge(gc).feat_colour() == GREEN
-            || env.map_knowledge(gc).feat_colour() == LIGHTGREEN)
+        if (env.map_knowledge.get(gc).feat_colour() == GREEN
+            || env.map_knowledge.get(gc).feat_colour() == LIGHTGREEN)
         {
             return TILE_DNGN_DEEP_WATER_MURKY;
         }
@@ -602,15 +648,15 @@ tileidx_t tileidx_feature(const coord_def &gc)
     case DNGN_SHALLOW_WATER:
         {
             tileidx_t t = TILE_DNGN_SHALLOW_WATER;
-            if (env.map_knowledge(gc).feat_colour() == GREEN
-                || env.map_knowledge(gc).feat_colour() == LIGHTGREEN)
+            if (env.map_knowledge.get(gc).feat_colour() == GREEN
+                || env.map_knowledge.get(gc).feat_colour() == LIGHTGREEN)
             {
                 t = TILE_DNGN_SHALLOW_WATER_MURKY;
             }
             else if (player_in_branch(BRANCH_SHOALS))
                 t = TILE_SHOALS_SHALLOW_WATER;
 
-            if (env.map_knowledge(gc).invisible_monster())
+            if (env.map_knowledge.get(gc).invisible_monster())
             {
                 // Add disturbance to tile.
                 t += tile_dngn_count(t);
@@ -912,10 +958,10 @@ void tileidx_out_of_los(tileidx_t *fg, tileidx_t *bg, tileidx_t *cloud, const co
     auto rays = *bg & (TILE_FLAG_RAY_MULTI | TILE_FLAG_RAY_OOR | TILE_FLAG_RAY
                         | TILE_FLAG_LANDING);
 
-    const map_cell &cell = env.map_knowledge(gc);
+    const map_cell &cell = env.map_knowledge.get(gc);
 
     // Override terrain for magic mapping.
-    if (!cell.seen() && env.map_knowledge(gc).mapped())
+    if (!cell.seen() && env.map_knowledge.get(gc).mapped())
         *bg = tileidx_feature_base(cell.feat());
     else
         *bg = mem_bg;
@@ -926,12 +972,12 @@ void tileidx_out_of_los(tileidx_t *fg, tileidx_t *bg, tileidx_t *cloud, const co
     *bg |= rays;
 
     // Override foreground for monsters/items
-    if (env.map_knowledge(gc).detected_monster())
+    if (env.map_knowledge.get(gc).detected_monster())
     {
         ASSERT(cell.monster() == MONS_SENSED);
         *fg = tileidx_monster_base(cell.monsterinfo()->base_type);
     }
-    else if (env.map_knowledge(gc).detected_item())
+    else if (env.map_knowledge.get(gc).detected_item())
         *fg = tileidx_item(*cell.item());
     else
         *fg = mem_fg;
@@ -1671,7 +1717,7 @@ static bool _tentacle_tile_not_flying(tileidx_t tile)
 
 static tileidx_t _tileidx_monster_no_props(const monster_info& mon)
 {
-    const bool in_water = feat_is_water(env.map_knowledge(mon.pos).feat());
+    const bool in_water = feat_is_water(env.map_knowledge.get(mon.pos).feat());
 
     // Show only base class for detected monsters.
     if (mons_class_is_zombified(mon.type))
@@ -1770,7 +1816,7 @@ static tileidx_t _tileidx_monster_no_props(const monster_info& mon)
         }
 
         case MONS_BUSH:
-            if (env.map_knowledge(mon.pos).cloud() == CLOUD_FIRE)
+            if (env.map_knowledge.get(mon.pos).cloud() == CLOUD_FIRE)
                 return TILEP_MONS_BUSH_BURNING;
             return base;
 
@@ -3858,10 +3904,10 @@ tileidx_t tileidx_unseen_flag(const coord_def &gc)
 {
     if (!map_bounds(gc))
         return TILE_FLAG_UNSEEN;
-    else if (env.map_knowledge(gc).known()
-                && !env.map_knowledge(gc).seen()
-             || env.map_knowledge(gc).detected_item()
-             || env.map_knowledge(gc).detected_monster()
+    else if (env.map_knowledge.get(gc).known()
+                && !env.map_knowledge.get(gc).seen()
+             || env.map_knowledge.get(gc).detected_item()
+             || env.map_knowledge.get(gc).detected_monster()
            )
     {
         return TILE_FLAG_MM_UNSEEN;
@@ -4074,3 +4120,67 @@ void tile_init_props(monster* mon)
 
     mon->props[TILE_NUM_KEY] = short(random2(256));
 }
+
+template <class F>
+static double _time_tile_lookups(int iterations, tileidx_t &sum, F lookup)
+{
+    const auto start = chrono::steady_clock::now();
+    int cells = 0;
+    for (int i = 0; i < iterations; ++i)
+        for (rectangle_iterator ri(0); ri; ++ri, ++cells)
+            sum += lookup(*ri);
+    const chrono::duration<double, nano> elapsed =
+        chrono::steady_clock::now() - start;
+    return cells ? elapsed.count() / cells : 0;
+}
+
+/**
+ * Time the tile lookups of a redraw of every cell of the current level, as
+ * the player knows it, repeated some number of times.
+ *
+ * @param iterations How many times to go over the level.
+ * @return           One line per kind of lookup, with the time per cell.
+ */
+string tileidx_benchmark(int iterations)
+{
+    tileidx_t sum = 0;
+    vector<pair<const char *, double>> times;
+
+    times.emplace_back("feature base",
+        _time_tile_lookups(iterations, sum, [](const coord_def &gc)
+        {
+            return tileidx_feature_base(env.map_knowledge.get(gc).feat());
+        }));
+    times.emplace_back("feature",
+        _time_tile_lookups(iterations, sum, [](const coord_def &gc)
+        {
+            return tileidx_feature(gc);
+        }));
+    times.emplace_back("monster",
+        _time_tile_lookups(iterations, sum, [](const coord_def &gc)
+        {
+            const monster_info *mi = env.map_knowledge.get(gc).monsterinfo();
+            return mi ? tileidx_monster(*mi) : 0;
+        }));
+    times.emplace_back("item",
+        _time_tile_lookups(iterations, sum, [](const coord_def &gc)
+        {
+            const item_info *item = env.map_knowledge.get(gc).item();
+            return item ? tileidx_item(*item) : 0;
+        }));
+#ifdef USE_TILE
+    times.emplace_back("map cell",
+        _time_tile_lookups(iterations, sum, [](const coord_def &gc)
+        {
+            tile_draw_map_cell(gc);
+            return env.tile_bk_fg(gc);
+        }));
+#endif
+
+    string result;
+    for (const auto &time : times)
+        result += make_stringf("%-12s %8.1f ns/cell\n", time.first, time.second);
+    // Keeps the lookups from being optimised away.
+    result += make_stringf("(checksum %u)\n", (unsigned int) sum);
+    return result;
+}
@@ -77,3 +77,5 @@ void tile_init_props(monster* mon);
 tileidx_t tileidx_monster_base(int type, bool in_water = false, int colour = 0,
                                int number = 4, int tile_num_prop = 0, bool vary = true);
 tileidx_t tileidx_mon_clamp(tileidx_t tile, int offset);
+
+string tileidx_benchmark(int iterations);
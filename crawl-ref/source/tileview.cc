@@ -837,9 +837,9 @@ static tileidx_t _get_floor_bg(const coord_def& gc)
         bg = tileidx_feature(gc);
 
         if (is_unknown_stair(gc)
-            && env.map_knowledge(gc).feat() != DNGN_ENTER_ZOT
+            && env.map_knowledge.get(gc).feat() != DNGN_ENTER_ZOT
             && !(player_in_hell()
-                 && env.map_knowledge(gc).feat() == DNGN_ENTER_HELL))
+                 && env.map_knowledge.get(gc).feat() == DNGN_ENTER_HELL))
         {
             bg |= TILE_FLAG_NEW_STAIR;
         }
@@ -939,7 +939,7 @@ static void _tile_place_item_marker(const coord_def &gc, const item_def &item)
 static void _tile_place_invisible_monster(const coord_def &gc)
 {
     const coord_def ep = grid2show(gc);
-    const map_cell& cell = env.map_knowledge(gc);
+    const map_cell& cell = env.map_knowledge.get(gc);
 
     // Shallow water has its own modified tile for disturbances
     // see tileidx_feature
@@ -1101,7 +1101,7 @@ void tile_draw_map_cell(const coord_def& gc, bool foreground_only)
         env.tile_cloud(grid2show(gc)) = 0;
     }
 
-    const map_cell& cell = env.map_knowledge(gc);
+    const map_cell& cell = env.map_knowledge.get(gc);
 
     if (cell.invisible_monster())
         _tile_place_invisible_monster(gc);
@@ -1430,7 +1430,7 @@ void tile_apply_properties(const coord_def &gc, packed_cell &cell)
 
     apply_variations(env.tile_flv(gc), &cell.bg, gc);
 
-    const map_cell& mc = env.map_knowledge(gc);
+    const map_cell& mc = env.map_knowledge.get(gc);
 
     bool print_blood = true;
     if (mc.flags & MAP_UMBRAED)
@@ -5,6 +5,7 @@
 #include "tileweb.h"
 
 #include <cerrno>
+#include <chrono>
 #include <cstdarg>
 #include <sys/socket.h>
 #include <sys/time.h>
@@ -34,6 +35,7 @@
 #include "options.h"
 #include "player.h"
 #include "player-equip.h"
+#include "random.h"
 #include "religion.h"
 #include "scroller.h"
 #include "skills.h"
@@ -52,6 +54,7 @@
 #include "tileview.h"
 #include "transform.h"
 #include "travel.h"
+#include "turn-profile.h"
 #include "unicode.h"
 #include "unwind.h"
 #include "version.h"
@@ -72,6 +75,7 @@ static unsigned int get_milliseconds()
 TilesFramework tiles;
 
 TilesFramework::TilesFramework() :
+      m_unsent_bytes(0),
       m_controlled_from_web(false),
       _send_lock(false),
       m_last_ui_state(UI_INIT),
@@ -159,20 +163,38 @@ string TilesFramework::get_message()
     return m_msg_buf;
 }
 
-void TilesFramework::write_message(const char *format, ...)
+void TilesFramework::_write_message(const char *format, va_list argp)
 {
-    char buf[2048];
-    int len;
+    // Most messages are plain text.
+    if (!strchr(format, '%'))
+    {
+        m_msg_buf.append(format);
+        return;
+    }
+
+    va_list again;
+    va_copy(again, argp);
+    char buf[256];
+    const int len = vsnprintf(buf, sizeof(buf), format, argp);
+    if (len < 0)
+        die("Webtiles message format error! (%s)", format);
+    else if (len < (int)sizeof(buf))
+        m_msg_buf.append(buf, len);
+    else
+    {
+        const size_t start = m_msg_buf.size();
+        m_msg_buf.resize(start + len);
+        vsnprintf(&m_msg_buf[start], len + 1, format, again);
+    }
+    va_end(again);
+}
 
+void TilesFramework::write_message(const char *format, ...)
+{
     va_list argp;
     va_start(argp, format);
-    if ((len = vsnprintf(buf, sizeof(buf), format, argp)) < 0)
-        die("Webtiles message format error! (%s)", format);
-    else if (len >= (int)sizeof(buf))
-        die("Webtiles message too long! (%d)", len);
+    _write_message(format, argp);
     va_end(argp);
-
-    m_msg_buf.append(buf);
 }
 
 void TilesFramework::finish_message()
@@ -186,11 +208,13 @@ void TilesFramework::finish_message()
 
     if (m_sock_name.empty())
     {
+        m_unsent_bytes += m_msg_buf.size();
         m_msg_buf.clear();
         return;
     }
 
     m_msg_buf.append("\n");
+    prof_count(PROF_WEBTILES_BYTES, m_msg_buf.size());
     const char* fragment_start = m_msg_buf.data();
     const char* data_end = m_msg_buf.data() + m_msg_buf.size();
     int fragments = 0;
@@ -271,23 +295,11 @@ void TilesFramework::finish_message()
 
 void TilesFramework::send_message(const char *format, ...)
 {
-    char buf[2048];
-    int len;
-
     va_list argp;
     va_start(argp, format);
-    if ((len = vsnprintf(buf, sizeof(buf), format, argp)) >= (int)sizeof(buf)
-        || len == -1)
-    {
-        if (len == -1)
-            die("Webtiles message format error! (%s)", format);
-        else
-            die("Webtiles message too long! (%d)", len);
-    }
+    _write_message(format, argp);
     va_end(argp);
 
-    m_msg_buf.append(buf);
-
     finish_message();
 }
 
@@ -769,7 +781,7 @@ void TilesFramework::update_input_mode(mouse_mode mode, bool force)
 
 static bool _update_string(bool force, string& current,
                            const string& next,
-                           const string& name,
+                           const char *name,
                            bool update = true)
 {
     if (force || current != next)
@@ -784,7 +796,7 @@ static bool _update_string(bool force, string& current,
 }
 
 template<class T> static bool _update_int(bool force, T& current, T next,
-                                          const string& name,
+                                          const char *name,
                                           bool update = true)
 {
     if (force || current != next)
@@ -1016,7 +1028,7 @@ void TilesFramework::_send_player(bool force_full)
     for (unsigned int i = EQ_FIRST_EQUIP; i < NUM_EQUIP; ++i)
     {
         const int8_t equip = !you.melded[i] ? you.equip[i] : -1;
-        _update_int(force_full, c.equip[i], equip, to_string(i));
+        _update_int(force_full, c.equip[i], equip, to_string(i).c_str());
     }
     json_close_object(true);
 
@@ -1271,9 +1283,15 @@ void TilesFramework::write_tileidx(tileidx_t t)
     const int lo = t & 0xFFFFFFFF;
     const int hi = t >> 32;
     if (hi == 0)
-        tiles.write_message("%d", lo);
+        _json_write_int(lo);
     else
-        tiles.write_message("[%d,%d]", lo, hi);
+    {
+        m_msg_buf.push_back('[');
+        _json_write_int(lo);
+        m_msg_buf.push_back(',');
+        _json_write_int(hi);
+        m_msg_buf.push_back(']');
+    }
 }
 
 void TilesFramework::_send_cell(const coord_def &gc,
@@ -1553,6 +1571,9 @@ void TilesFramework::_send_map(bool force_full)
 
     unwind_bool no_rentry(_send_lock, true);
 
+    // Whether a turn is sent must not change the game's random numbers.
+    rng_generator rng(RNG_UI);
+
     map<uint32_t, coord_def> new_monster_locs;
 
     force_full = force_full || m_need_full_map;
@@ -1590,15 +1611,11 @@ void TilesFramework::_send_map(bool force_full)
 
     coord_def last_gc(0, 0);
     bool send_gc = true;
+    vector<coord_def> sent_cells;
 
-    json_open_array("cells");
-    for (int y = 0; y < GYM; y++)
-        for (int x = 0; x < GXM; x++)
+    auto send = [&](const coord_def &gc)
         {
-            coord_def gc(x, y);
-
-            if (!is_dirty(gc) && !force_full)
-                continue;
+            const int x = gc.x, y = gc.y;
 
             if (cell_needs_redraw(gc))
             {
@@ -1610,6 +1627,7 @@ void TilesFramework::_send_map(bool force_full)
             }
 
             mark_clean(gc);
+            sent_cells.push_back(gc);
 
             if (m_origin.equals(-1, -1))
                 m_origin = gc;
@@ -1627,11 +1645,11 @@ void TilesFramework::_send_map(bool force_full)
             const screen_cell_t& sc = force_full ? default_cell
                 : m_current_view(gc);
             const map_cell& mc = force_full ? default_map_cell
-                : m_current_map_knowledge(gc);
+                : m_current_map_knowledge.get(gc);
             _send_cell(gc,
                        sc,
                        m_next_view(gc),
-                       mc, env.map_knowledge(gc),
+                       mc, env.map_knowledge.get(gc),
                        new_monster_locs, force_full);
 
             if (!json_is_empty())
@@ -1640,7 +1658,32 @@ void TilesFramework::_send_map(bool force_full)
                 last_gc = gc;
             }
             json_close_object(true);
-        }
+        };
+
+    json_open_array("cells");
+    if (force_full)
+    {
+        for (int y = 0; y < GYM; y++)
+            for (int x = 0; x < GXM; x++)
+                send(coord_def(x, y));
+    }
+    else
+    {
+        vector<coord_def> dirty;
+        dirty.swap(m_dirty_list);
+        // Row by row, so that runs of cells can leave out their position.
+        sort(dirty.begin(), dirty.end(),
+             [](const coord_def &a, const coord_def &b)
+             {
+                 return a.y < b.y || a.y == b.y && a.x < b.x;
+             });
+        for (const coord_def &gc : dirty)
+            if (is_dirty(gc))
+                send(gc);
+    }
+    // Drawing may have marked more cells; keep only those still to send.
+    erase_if(m_dirty_list, [this](const coord_def &gc)
+                           { return !is_dirty(gc); });
     json_close_array(true);
 
     json_close_object(true);
@@ -1653,8 +1696,12 @@ void TilesFramework::_send_map(bool force_full)
     if (m_mcache_ref_done)
         _mcache_ref(false);
 
+    // Both only share blocks, or copy the cells that were sent: cells that
+    // weren't can only differ in their map knowledge, which _send_cell()
+    // takes from m_current_map_knowledge instead.
     m_current_map_knowledge = env.map_knowledge;
-    m_current_view = m_next_view;
+    for (const coord_def &gc : sent_cells)
+        m_current_view(gc) = m_next_view(gc);
 
     _mcache_ref(true);
     m_mcache_ref_done = true;
@@ -1678,14 +1725,14 @@ void TilesFramework::_send_monster(const coord_def &gc, const monster_info* m,
     auto it = m_monster_locs.find(m->client_id);
     if (m->client_id == 0 || it == m_monster_locs.end())
     {
-        last = m_current_map_knowledge(gc).monsterinfo();
+        last = m_current_map_knowledge.get(gc).monsterinfo();
 
         if (last && last->client_id != m->client_id)
             json_treat_as_nonempty(); // Force sending at least the id
     }
     else
     {
-        last = m_current_map_knowledge(it->second).monsterinfo();
+        last = m_current_map_knowledge.get(it->second).monsterinfo();
 
         if (it->second != gc)
             json_treat_as_nonempty(); // As above
@@ -1756,13 +1803,16 @@ void TilesFramework::load_dungeon(const crawl_view_buffer &vbuf,
 
     // re-cache the map knowledge for the whole map, not just the updated portion
     // fixes render bugs for out-of-LOS when transitioning levels in shoals/slime
-    for (int y = 0; y < GYM; y++)
-        for (int x = 0; x < GXM; x++)
+    // Only the blocks of map knowledge written to since the last time can
+    // differ from what m_next_view has.
+    env.map_knowledge.for_each_changed(m_next_view_knowledge, [&](int x, int y)
         {
             const coord_def gc(x, y);
             screen_cell_t *cell = &m_next_view(gc);
-            cell->tile.map_knowledge = map_bounds(gc) ? env.map_knowledge(gc) : map_cell();
-        }
+            cell->tile.map_knowledge = map_bounds(gc) ? env.map_knowledge.get(gc)
+                                                      : map_cell();
+        });
+    m_next_view_knowledge = env.map_knowledge;
 
     m_next_view_tl = view2grid(coord_def(1, 1));
     m_next_view_br = view2grid(crawl_view.viewsz);
@@ -1922,6 +1972,8 @@ void TilesFramework::redraw()
         return;
     }
 
+    prof_timer timer(PROF_WEBTILES);
+
     if (m_layout_reset)
     {
         _send_layout();
@@ -2141,7 +2193,10 @@ void TilesFramework::mark_for_redraw(const coord_def& gc)
 
 void TilesFramework::mark_dirty(const coord_def& gc)
 {
+    if (m_dirty_cells[gc.y * GXM + gc.x])
+        return;
     m_dirty_cells[gc.y * GXM + gc.x] = true;
+    m_dirty_list.push_back(gc);
 }
 
 void TilesFramework::mark_clean(const coord_def& gc)
@@ -2160,36 +2215,52 @@ bool TilesFramework::cell_needs_redraw(const coord_def& gc)
     return m_cells_needing_redraw[gc.y * GXM + gc.x];
 }
 
-void TilesFramework::write_message_escaped(const string& s)
+void TilesFramework::_write_escaped(const char *s, size_t len)
 {
-    for (unsigned char c : s)
+    static const char hex[] = "0123456789abcdef";
+
+    // Copy runs of plain characters in one go.
+    const char *run = s;
+    const char *end = s + len;
+    for (const char *p = s; p < end; ++p)
     {
+        const unsigned char c = *p;
+        if (c != '"' && c != '\\' && c >= 0x20)
+            continue;
+
+        m_msg_buf.append(run, p - run);
+        run = p + 1;
         if (c == '"')
-            m_msg_buf.append("\\\"");
+            m_msg_buf.append("\\\"", 2);
         else if (c == '\\')
-            m_msg_buf.append("\\\\");
-        else if (c < 0x20)
+            m_msg_buf.append("\\\\", 2);
+        else
         {
-            char buf[7];
-            snprintf(buf, sizeof(buf), "\\u%04x", c);
-            m_msg_buf.append(buf);
+            const char esc[] = { '\\', 'u', '0', '0',
+                                 hex[c >> 4], hex[c & 0xF] };
+            m_msg_buf.append(esc, sizeof(esc));
         }
-        else
-            m_msg_buf.push_back(c);
     }
+    m_msg_buf.append(run, end - run);
+}
+
+void TilesFramework::write_message_escaped(const string& s)
+{
+    _write_escaped(s.data(), s.size());
 }
 
-void TilesFramework::json_open(const string& name, char opener, char type)
+void TilesFramework::json_open(const char *name, size_t name_len,
+                               char opener, char type)
 {
     m_json_stack.resize(m_json_stack.size() + 1);
     JsonFrame& fr = m_json_stack.back();
     fr.start = m_msg_buf.size();
 
     json_write_comma();
-    if (!name.empty())
-        json_write_name(name);
+    if (name_len)
+        _json_write_name(name, name_len);
 
-    m_msg_buf.append(1, opener);
+    m_msg_buf.push_back(opener);
 
     fr.prefix_end = m_msg_buf.size();
     fr.type = type;
@@ -2226,14 +2297,19 @@ void TilesFramework::json_close(bool erase_if_empty, char type)
     if (erase_if_empty && json_is_empty())
         m_msg_buf.resize(m_json_stack.back().start);
     else
-        m_msg_buf.append(1, type);
+        m_msg_buf.push_back(type);
 
     m_json_stack.pop_back();
 }
 
+void TilesFramework::json_open_object(const char *name)
+{
+    json_open(name, strlen(name), '{', '}');
+}
+
 void TilesFramework::json_open_object(const string& name)
 {
-    json_open(name, '{', '}');
+    json_open(name.data(), name.size(), '{', '}');
 }
 
 void TilesFramework::json_close_object(bool erase_if_empty)
@@ -2241,9 +2317,14 @@ void TilesFramework::json_close_object(bool erase_if_empty)
     json_close(erase_if_empty, '}');
 }
 
+void TilesFramework::json_open_array(const char *name)
+{
+    json_open(name, strlen(name), '[', ']');
+}
+
 void TilesFramework::json_open_array(const string& name)
 {
-    json_open(name, '[', ']');
+    json_open(name.data(), name.size(), '[', ']');
 }
 
 void TilesFramework::json_close_array(bool erase_if_empty)
@@ -2256,73 +2337,142 @@ void TilesFramework::json_write_comma()
     if (m_msg_buf.empty()) return;
     char last = m_msg_buf[m_msg_buf.size() - 1];
     if (last == '{' || last == '[' || last == ',' || last == ':') return;
-    write_message(",");
+    m_msg_buf.push_back(',');
 }
 
-void TilesFramework::json_write_name(const string& name)
+void TilesFramework::_json_write_name(const char *name, size_t len)
 {
     json_write_comma();
 
-    write_message("\"");
-    write_message_escaped(name);
-    write_message("\":");
+    m_msg_buf.push_back('"');
+    _write_escaped(name, len);
+    m_msg_buf.append("\":", 2);
+}
+
+void TilesFramework::json_write_name(const char *name)
+{
+    _json_write_name(name, strlen(name));
+}
+
+void TilesFramework::json_write_name(const string& name)
+{
+    _json_write_name(name.data(), name.size());
+}
+
+// Same as printf's %d.
+void TilesFramework::_json_write_int(int value)
+{
+    char buf[12];
+    char *const end = buf + sizeof(buf);
+    char *p = end;
+    unsigned int u = value < 0 ? 0U - (unsigned int) value : value;
+    do
+    {
+        *--p = '0' + u % 10;
+        u /= 10;
+    }
+    while (u);
+    if (value < 0)
+        *--p = '-';
+    m_msg_buf.append(p, end - p);
 }
 
 void TilesFramework::json_write_int(int value)
 {
     json_write_comma();
 
-    write_message("%d", value);
+    _json_write_int(value);
 }
 
-void TilesFramework::json_write_int(const string& name, int value)
+void TilesFramework::json_write_int(const char *name, int value)
 {
-    if (!name.empty())
+    if (*name)
         json_write_name(name);
 
     json_write_int(value);
 }
 
+void TilesFramework::json_write_int(const string& name, int value)
+{
+    json_write_int(name.c_str(), value);
+}
+
 void TilesFramework::json_write_bool(bool value)
 {
     json_write_comma();
 
     if (value)
-        write_message("true");
+        m_msg_buf.append("true", 4);
     else
-        write_message("false");
+        m_msg_buf.append("false", 5);
 }
 
-void TilesFramework::json_write_bool(const string& name, bool value)
+void TilesFramework::json_write_bool(const char *name, bool value)
 {
-    if (!name.empty())
+    if (*name)
         json_write_name(name);
 
     json_write_bool(value);
 }
 
+void TilesFramework::json_write_bool(const string& name, bool value)
+{
+    json_write_bool(name.c_str(), value);
+}
+
 void TilesFramework::json_write_null()
 {
     json_write_comma();
 
-    write_message("null");
+    m_msg_buf.append("null", 4);
 }
 
-void TilesFramework::json_write_null(const string& name)
+void TilesFramework::json_write_null(const char *name)
 {
-    if (!name.empty())
+    if (*name)
         json_write_name(name);
 
     json_write_null();
 }
 
-void TilesFramework::json_write_string(const string& value)
+void TilesFramework::json_write_null(const string& name)
+{
+    json_write_null(name.c_str());
+}
+
+void TilesFramework::_json_write_string(const char *value, size_t len)
 {
     json_write_comma();
 
-    write_message("\"");
-    write_message_escaped(value);
-    write_message("\"");
+    m_msg_buf.push_back('"');
+    _write_escaped(value, len);
+    m_msg_buf.push_back('"');
+}
+
+void TilesFramework::json_write_string(const char *value)
+{
+    _json_write_string(value, strlen(value));
+}
+
+void TilesFramework::json_write_string(const string& value)
+{
+    _json_write_string(value.data(), value.size());
+}
+
+void TilesFramework::json_write_string(const char *name, const char *value)
+{
+    if (*name)
+        json_write_name(name);
+
+    json_write_string(value);
+}
+
+void TilesFramework::json_write_string(const char *name, const string& value)
+{
+    if (*name)
+        json_write_name(name);
+
+    json_write_string(value);
 }
 
 void TilesFramework::json_write_string(const string& name, const string& value)
@@ -2333,6 +2483,43 @@ void TilesFramework::json_write_string(const string& name, const string& value)
     json_write_string(value);
 }
 
+/**
+ * Time writing the full player and map messages that a new spectator gets,
+ * without sending them anywhere. Everything is sent again afterwards, so
+ * that watchers don't miss what the timed messages would have told them.
+ *
+ * @param iterations How many pairs of messages to write.
+ * @return           The time and size of a pair, and the rate of writing.
+ */
+string TilesFramework::benchmark_frames(int iterations)
+{
+    const size_t unsent_before = m_unsent_bytes;
+    chrono::duration<double> elapsed(0);
+    {
+        unwind_var<string> no_socket(m_sock_name, "");
+        const auto start = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            _send_player(true);
+            _send_map(true);
+        }
+        elapsed = chrono::steady_clock::now() - start;
+    }
+    const double bytes = m_unsent_bytes - unsent_before;
+    m_unsent_bytes = unsent_before;
+
+    if (!m_sock_name.empty())
+        _send_everything();
+
+    const double seconds = elapsed.count();
+    return make_stringf("%-10s %10.1f us/frame\n"
+                        "%-10s %10.0f bytes/frame\n"
+                        "%-10s %10.1f MB/s\n",
+                        "time", seconds * 1e6 / iterations,
+                        "size", bytes / iterations,
+                        "rate", seconds > 0 ? bytes / seconds / 1e6 : 0.0);
+}
+
 bool is_tiles()
 {
     return tiles.is_controlled_from_web();
@@ -8,10 +8,12 @@
 #ifdef USE_TILE_WEB
 
 #include <bitset>
+#include <cstdarg>
 #include <map>
 #include <sys/un.h>
 
 #include "cursor-type.h"
+#include "env.h"
 #include "equipment-type.h"
 #include "map-cell.h"
 #include "map-knowledge.h"
@@ -172,20 +174,31 @@ public:
     void check_for_control_messages();
 
     // Helper functions for writing JSON
+    // The const char * overloads save building a string out of each
+    // literal name and value.
     void write_message_escaped(const string& s);
-    void json_open_object(const string& name = "");
+    void json_open_object(const char *name = "");
+    void json_open_object(const string& name);
     void json_close_object(bool erase_if_empty = false);
-    void json_open_array(const string& name = "");
+    void json_open_array(const char *name = "");
+    void json_open_array(const string& name);
     void json_close_array(bool erase_if_empty = false);
     void json_write_comma();
+    void json_write_name(const char *name);
     void json_write_name(const string& name);
     void json_write_int(int value);
+    void json_write_int(const char *name, int value);
     void json_write_int(const string& name, int value);
     void json_write_bool(bool value);
+    void json_write_bool(const char *name, bool value);
     void json_write_bool(const string& name, bool value);
     void json_write_null();
+    void json_write_null(const char *name);
     void json_write_null(const string& name);
+    void json_write_string(const char *value);
     void json_write_string(const string& value);
+    void json_write_string(const char *name, const char *value);
+    void json_write_string(const char *name, const string& value);
     void json_write_string(const string& name, const string& value);
     /* Causes the current object/array to be erased if it is closed
        with erase_if_empty without writing any other content after
@@ -208,12 +221,19 @@ public:
                      bool send_doll = true);
     void write_tileidx(tileidx_t t);
 
+    string benchmark_frames(int iterations);
+
     void zoom_dungeon(bool in);
 
 protected:
     int m_sock;
     int m_max_msg_size;
+    // Cleared but never shrunk after each message, so that messages are
+    // built without allocating once it has grown to the largest frame.
     string m_msg_buf;
+    // Bytes of the messages finished while there was no socket to send them
+    // to; only benchmark_frames() looks at this.
+    size_t m_unsent_bytes;
     vector<sockaddr_un> m_dest_addrs;
 
     bool m_controlled_from_web;
@@ -233,8 +253,14 @@ protected:
     };
     vector<JsonFrame> m_json_stack;
 
-    void json_open(const string& name, char opener, char type);
+    void json_open(const char *name, size_t name_len, char opener,
+                   char type);
     void json_close(bool erase_if_empty, char type);
+    void _json_write_name(const char *name, size_t len);
+    void _json_write_int(int value);
+    void _json_write_string(const char *value, size_t len);
+    void _write_escaped(const char *s, size_t len);
+    void _write_message(const char *format, va_list argp);
 
     struct UIStackFrame
     {
@@ -268,6 +294,9 @@ protected:
     coord_def m_next_view_br;
 
     bitset<GXM * GYM> m_dirty_cells;
+    // Cells marked dirty since the last map message; may repeat cells, or
+    // hold some that were marked clean again.
+    vector<coord_def> m_dirty_list;
     bitset<GXM * GYM> m_cells_needing_redraw;
     void mark_dirty(const coord_def& gc);
     void mark_clean(const coord_def& gc);
@@ -277,7 +306,11 @@ protected:
     int m_current_flash_colour;
     int m_next_flash_colour;
 
-    FixedArray<map_cell, GXM, GYM> m_current_map_knowledge;
+    // What the client was last sent, and what m_next_view's map knowledge
+    // was last brought up to date with; both share unchanged blocks with
+    // env.map_knowledge.
+    MapKnowledge m_current_map_knowledge;
+    MapKnowledge m_next_view_knowledge;
     map<uint32_t, coord_def> m_monster_locs;
     bool m_need_full_map;
 
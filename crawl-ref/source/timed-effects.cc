@@ -31,7 +31,6 @@
 #include "mon-death.h"
 #include "mon-pathfind.h"
 #include "mon-place.h"
-#include "mon-project.h"
 #include "mutation.h"
 #include "player.h"
 #include "player-stats.h"
@@ -50,7 +49,6 @@
 #include "throw.h"
 #include "travel.h"
 #include "viewchar.h"
-#include "unwind.h"
 
 /**
  * Choose a random, spooky hell effect message, print it, and make a loud noise
@@ -455,247 +453,6 @@ void handle_time()
     }
 }
 
-/**
- * Return the number of turns it takes for monsters to forget about the player
- * 50% of the time.
- *
- * @param   The intelligence of the monster.
- * @return  An average number of turns before the monster forgets.
- */
-static int _mon_forgetfulness_time(mon_intel_type intelligence)
-{
-    switch (intelligence)
-    {
-        case I_HUMAN:
-            return 600;
-        case I_ANIMAL:
-            return 300;
-        case I_BRAINLESS:
-            return 150;
-        default:
-            die("Invalid intelligence type!");
-    }
-}
-
-/**
- * Make monsters forget about the player after enough time passes off-level.
- *
- * @param mon           The monster in question.
- * @param mon_turns     Monster turns. (Turns * monster speed)
- * @return              Whether the monster forgot about the player.
- */
-static bool _monster_forget(monster* mon, int mon_turns)
-{
-    // After x turns, half of the monsters will have forgotten about the
-    // player. A given monster has a 95% chance of forgetting the player after
-    // 4*x turns.
-    const int forgetfulness_time = _mon_forgetfulness_time(mons_intel(*mon));
-    const int forget_chances = mon_turns / forgetfulness_time;
-    // n.b. this is an integer division, so if range < forgetfulness_time
-    // nothing happens
-
-    if (bernoulli(forget_chances, 0.5))
-    {
-        mon->behaviour = BEH_WANDER;
-        mon->foe = MHITNOT;
-        mon->target = random_in_bounds();
-        return true;
-    }
-
-    return false;
-}
-
-/**
- * Make ranged monsters flee from the player during their time offlevel.
- *
- * @param mon           The monster in question.
- */
-static void _monster_flee(monster *mon)
-{
-    mon->behaviour = BEH_FLEE;
-    dprf("backing off...");
-
-    if (mon->pos() != mon->target)
-        return;
-    // If the monster is on the target square, fleeing won't work.
-
-    if (in_bounds(env.old_player_pos) && env.old_player_pos != mon->pos())
-    {
-        // Flee from player's old position if different.
-        mon->target = env.old_player_pos;
-        return;
-    }
-
-    // Randomise the target so we have a direction to flee.
-    coord_def mshift;
-    mshift.x = random2(3) - 1;
-    mshift.y = random2(3) - 1;
-
-    // Bounds check: don't let fleeing monsters try to run off the grid.
-    const coord_def s = mon->target + mshift;
-    if (!in_bounds_x(s.x))
-        mshift.x = 0;
-    if (!in_bounds_y(s.y))
-        mshift.y = 0;
-
-    mon->target.x += mshift.x;
-    mon->target.y += mshift.y;
-
-    return;
-}
-
-/**
- * Make a monster take a number of moves toward (or away from, if fleeing)
- * their current target, very crudely.
- *
- * @param mon       The mon in question.
- * @param moves     The number of moves to take.
- */
-static void _catchup_monster_move(monster* mon, int moves)
-{
-    coord_def pos(mon->pos());
-
-    // Dirt simple movement.
-    for (int i = 0; i < moves; ++i)
-    {
-        coord_def inc(mon->target - pos);
-        inc = coord_def(sgn(inc.x), sgn(inc.y));
-
-        if (mons_is_retreating(*mon))
-            inc *= -1;
-
-        // Bounds check: don't let shifting monsters try to run off the
-        // grid.
-        const coord_def s = pos + inc;
-        if (!in_bounds_x(s.x))
-            inc.x = 0;
-        if (!in_bounds_y(s.y))
-            inc.y = 0;
-
-        if (inc.origin())
-            break;
-
-        const coord_def next(pos + inc);
-        const dungeon_feature_type feat = grd(next);
-        if (feat_is_solid(feat)
-            || monster_at(next)
-            || !monster_habitable_grid(mon, feat))
-        {
-            break;
-        }
-
-        pos = next;
-    }
-
-    if (!mon->shift(pos))
-        mon->shift(mon->pos());
-}
-
-/**
- * Move monsters around to fake them walking around while player was
- * off-level.
- *
- * Does not account for monster move speeds.
- *
- * Also make them forget about the player over time.
- *
- * @param mon       The monster under consideration
- * @param turns     The number of offlevel player turns to simulate.
- */
-static void _catchup_monster_moves(monster* mon, int turns)
-{
-    // Summoned monsters might have disappeared.
-    if (!mon->alive())
-        return;
-
-    // Ball lightning dissapates harmlessly out of LOS
-    if (mon->type == MONS_BALL_LIGHTNING && mon->summoner == MID_PLAYER)
-    {
-        monster_die(*mon, KILL_RESET, NON_MONSTER);
-        return;
-    }
-
-    // Expire friendly summons
-    if (mon->friendly() && mon->is_summoned() && !mon->is_perm_summoned())
-    {
-        // You might still see them disappear if you were quick
-        if (turns > 2)
-            monster_die(*mon, KILL_DISMISSED, NON_MONSTER);
-        else
-        {
-            mon_enchant abj  = mon->get_ench(ENCH_ABJ);
-            abj.duration = 0;
-            mon->update_ench(abj);
-        }
-        return;
-    }
-
-    // Don't move non-land or stationary monsters around.
-    if (mons_primary_habitat(*mon) != HT_LAND
-        || mons_is_zombified(*mon)
-           && mons_class_primary_habitat(mon->base_monster) != HT_LAND
-        || mon->is_stationary())
-    {
-        return;
-    }
-
-    // Don't shift ballistomycete spores since that would disrupt their trail.
-    if (mon->type == MONS_BALLISTOMYCETE_SPORE)
-        return;
-
-    // special movement code for ioods
-    if (mons_is_projectile(*mon))
-    {
-        iood_catchup(mon, turns);
-        return;
-    }
-
-    // Let sleeping monsters lie.
-    if (mon->asleep() || mon->paralysed())
-        return;
-
-
-
-    const int mon_turns = (turns * mon->speed) / 10;
-    const int moves = min(mon_turns, 50);
-
-    // probably too annoying even for DEBUG_DIAGNOSTICS
-    dprf("mon #%d: range %d; "
-         "pos (%d,%d); targ %d(%d,%d); flags %" PRIx64,
-         mon->mindex(), mon_turns, mon->pos().x, mon->pos().y,
-         mon->foe, mon->target.x, mon->target.y, mon->flags.flags);
-
-    if (mon_turns <= 0)
-        return;
-
-
-    // did the monster forget about the player?
-    const bool forgot = _monster_forget(mon, mon_turns);
-
-    // restore behaviour later if we start fleeing
-    unwind_var<beh_type> saved_beh(mon->behaviour);
-
-    if (!forgot && mons_has_ranged_attack(*mon))
-    {
-        // If we're doing short time movement and the monster has a
-        // ranged attack (missile or spell), then the monster will
-        // flee to gain distance if it's "too close", else it will
-        // just shift its position rather than charge the player. -- bwr
-        if (grid_distance(mon->pos(), mon->target) >= 3)
-        {
-            mon->shift(mon->pos());
-            dprf("shifted to (%d, %d)", mon->pos().x, mon->pos().y);
-            return;
-        }
-
-        _monster_flee(mon);
-    }
-
-    _catchup_monster_move(mon, moves);
-
-    dprf("moved to (%d, %d)", mon->pos().x, mon->pos().y);
-}
-
 /**
  * Update a monster's enchantments when the player returns
  * to the level.
@@ -826,97 +583,6 @@ void monster::timeout_enchantments(int levels)
     }
 }
 
-/**
- * Update the level upon the player's return.
- *
- * @param elapsedTime how long the player was away.
- */
-void update_level(int elapsedTime)
-{
-    ASSERT(!crawl_state.game_is_arena());
-
-    const int turns = elapsedTime / 10;
-
-#ifdef DEBUG_DIAGNOSTICS
-    int mons_total = 0;
-
-    dprf("turns: %d", turns);
-#endif
-
-    rot_floor_items(elapsedTime);
-    shoals_apply_tides(turns, true, turns < 5);
-    timeout_tombs(turns);
-    timeout_terrain_changes(elapsedTime);
-
-    if (env.sanctuary_time)
-    {
-        if (turns >= env.sanctuary_time)
-            remove_sanctuary();
-        else
-            env.sanctuary_time -= turns;
-    }
-
-    dungeon_events.fire_event(
-        dgn_event(DET_TURN_ELAPSED, coord_def(0, 0), turns * 10));
-
-    for (monster_iterator mi; mi; ++mi)
-    {
-#ifdef DEBUG_DIAGNOSTICS
-        mons_total++;
-#endif
-
-        if (!update_monster(**mi, turns))
-            continue;
-    }
-
-#ifdef DEBUG_DIAGNOSTICS
-    dprf("total monsters on level = %d", mons_total);
-#endif
-
-    delete_all_clouds();
-}
-
-/**
- * Update the monster upon the player's return
- *
- * @param mon   The monster to update.
- * @param turns How many turns (not auts) since the monster left the player
- * @returns     Returns nullptr if monster was destroyed by the update;
- *              Returns the updated monster if it still exists.
- */
-monster* update_monster(monster& mon, int turns)
-{
-    // Pacified monsters often leave the level now.
-    if (mon.pacified() && turns > random2(40) + 21)
-    {
-        make_mons_leave_level(&mon);
-        return nullptr;
-    }
-
-    // Ignore monsters flagged to skip their next action
-    if (mon.flags & MF_JUST_SUMMONED)
-        return &mon;
-
-    // XXX: Allow some spellcasting (like Healing and Teleport)? - bwr
-    // const bool healthy = (mon->hit_points * 2 > mon->max_hit_points);
-
-    mon.heal(div_rand_round(turns * mon.off_level_regen_rate(), 100));
-
-    // Handle nets specially to remove the trapping property of the net.
-    if (mon.caught())
-        mon.del_ench(ENCH_HELD, true);
-
-    _catchup_monster_moves(&mon, turns);
-
-    mon.foe_memory = max(mon.foe_memory - turns, 0);
-
-    // FIXME:  Convert literal string 10 to constant to convert to auts
-    if (turns >= 10 && mon.alive())
-        mon.timeout_enchantments(turns / 10);
-
-    return &mon;
-}
-
 static void _drop_tomb(const coord_def& pos, bool premature, bool zin)
 {
     int count = 0;
@@ -5,8 +5,6 @@
 
 #pragma once
 
-void update_level(int elapsedTime);
-monster* update_monster(monster& mon, int turns);
 void handle_time();
 
 void timeout_tombs(int duration);
@@ -56,6 +56,7 @@
 #include "terrain.h"
 #include "tiles-build-specific.h"
 #include "traps.h"
+#include "turn-profile.h"
 #include "unicode.h"
 #include "unwind.h"
 #include "view.h"
@@ -195,12 +196,12 @@ static bool _is_travelsafe_square(const coord_def& c,
 //
 static inline bool is_trap(const coord_def& c)
 {
-    return feat_is_trap(env.map_knowledge(c).feat());
+    return feat_is_trap(env.map_knowledge.get(c).feat());
 }
 
 static inline bool _is_safe_cloud(const coord_def& c)
 {
-    const cloud_type ctype = env.map_knowledge(c).cloud();
+    const cloud_type ctype = env.map_knowledge.get(c).cloud();
     if (ctype == CLOUD_NONE)
         return true;
 
@@ -230,7 +231,7 @@ static inline int _feature_traverse_cost(dungeon_feature_type feature)
 
 bool is_unknown_stair(const coord_def &p)
 {
-    dungeon_feature_type feat = env.map_knowledge(p).feat();
+    dungeon_feature_type feat = env.map_knowledge.get(p).feat();
 
     return feat_is_travelable_stair(feat) && !travel_cache.know_stair(p)
            && feat != DNGN_EXIT_DUNGEON;
@@ -245,7 +246,7 @@ bool is_unknown_stair(const coord_def &p)
  **/
 bool is_unknown_transporter(const coord_def &p)
 {
-    dungeon_feature_type feat = env.map_knowledge(p).feat();
+    dungeon_feature_type feat = env.map_knowledge.get(p).feat();
 
     return feat == DNGN_TRANSPORTER && !travel_cache.know_transporter(p);
 }
@@ -405,7 +406,7 @@ public:
 
 bool is_stair_exclusion(const coord_def &p)
 {
-    if (feat_stair_direction(env.map_knowledge(p).feat()) == CMD_NO_CMD)
+    if (feat_stair_direction(env.map_knowledge.get(p).feat()) == CMD_NO_CMD)
         return false;
 
     return get_exclusion_radius(p) == 1;
@@ -427,10 +428,10 @@ static bool _is_travelsafe_square(const coord_def& c, bool ignore_hostile,
                : cell.safe;
     }
 
-    if (!env.map_knowledge(c).known())
+    if (!env.map_knowledge.get(c).known())
         return false;
 
-    const dungeon_feature_type grid = env.map_knowledge(c).feat();
+    const dungeon_feature_type grid = env.map_knowledge.get(c).feat();
 
     // Only try pathing through temporary obstructions we remember, not
     // those we can actually see (since the latter are clearly still blockers)
@@ -439,7 +440,7 @@ static bool _is_travelsafe_square(const coord_def& c, bool ignore_hostile,
 
     // Also make note of what's displayed on the level map for
     // plant/fungus checks.
-    const map_cell& levelmap_cell = env.map_knowledge(c);
+    const map_cell& levelmap_cell = env.map_knowledge.get(c);
 
     // Travel will not voluntarily cross squares blocked by immobile
     // monsters.
@@ -472,7 +473,7 @@ static bool _is_travelsafe_square(const coord_def& c, bool ignore_hostile,
     {
         trap_def trap;
         trap.pos = c;
-        trap.type = env.map_knowledge(c).trap();
+        trap.type = env.map_knowledge.get(c).trap();
         trap.ammo_qty = 1;
         if (trap.is_safe())
             return true;
@@ -650,7 +651,7 @@ static bool _is_valid_explore_target(const coord_def& where)
 {
     // If a square in LOS is unmapped, it's valid.
     for (radius_iterator ri(where, LOS_DEFAULT, true); ri; ++ri)
-        if (!env.map_knowledge(*ri).seen())
+        if (!env.map_knowledge.get(*ri).seen())
             return true;
 
     if (you.running == RMODE_EXPLORE_GREEDY)
@@ -1036,7 +1037,7 @@ static void _fill_exclude_radius(const travel_exclude &exc)
 
             if (is_exclude_root(p))
                 travel_point_distance[x][y] = PD_EXCLUDED;
-            else if (is_excluded(p) && env.map_knowledge(p).known())
+            else if (is_excluded(p) && env.map_knowledge.get(p).known())
                 travel_point_distance[x][y] = PD_EXCLUDED_RADIUS;
         }
 }
@@ -1151,6 +1152,8 @@ const coord_def travel_pathfind::unexplored_square() const
 // Allison - used with his permission.
 coord_def travel_pathfind::pathfind(run_mode_type rmode, bool fallback_explore)
 {
+    prof_count(PROF_TRAVEL_PATHFINDS);
+
     unwind_bool saved_ipt(ignore_player_traversability);
 
     if (rmode == RMODE_INTERLEVEL)
@@ -1350,7 +1353,7 @@ void travel_pathfind::get_features()
     for (dc.x = X_BOUND_1; dc.x <= X_BOUND_2; ++dc.x)
         for (dc.y = Y_BOUND_1; dc.y <= Y_BOUND_2; ++dc.y)
         {
-            const dungeon_feature_type feature = env.map_knowledge(dc).feat();
+            const dungeon_feature_type feature = env.map_knowledge.get(dc).feat();
 
             if ((feature != DNGN_FLOOR
                     && !feat_is_water(feature)
@@ -1385,7 +1388,7 @@ bool travel_pathfind::square_slows_movement(const coord_def &c)
     // c is a known (explored) location - we never put unknown points in the
     // circumference vector, so we don't need to examine the map array, just the
     // grid array.
-    const dungeon_feature_type feature = env.map_knowledge(c).feat();
+    const dungeon_feature_type feature = env.map_knowledge.get(c).feat();
 
     // If this is a feature that'll take time to travel past, we simulate that
     // extra turn by taking this feature next turn, thereby artificially
@@ -1434,7 +1437,7 @@ bool travel_pathfind::path_flood(const coord_def &c, const coord_def &dc)
     if (floodout
         && (runmode == RMODE_EXPLORE || runmode == RMODE_EXPLORE_GREEDY))
     {
-        if (!env.map_knowledge(dc).seen())
+        if (!env.map_knowledge.get(dc).seen())
         {
             if (ignore_hostile && !player_in_branch(BRANCH_SHOALS))
             {
@@ -1485,7 +1488,7 @@ bool travel_pathfind::path_flood(const coord_def &c, const coord_def &dc)
                     {
                         const coord_def ddc = dc + Compass[dir];
 
-                        if (feat_is_wall(env.map_knowledge(ddc).feat()))
+                        if (feat_is_wall(env.map_knowledge.get(ddc).feat()))
                             dist -= Options.explore_wall_bias;
                     }
                 }
@@ -1533,7 +1536,7 @@ bool travel_pathfind::path_flood(const coord_def &c, const coord_def &dc)
     // taking this transporter.
     if (!ignore_danger
         && is_excluded(c)
-        && env.map_knowledge(c).feat() == DNGN_TRANSPORTER
+        && env.map_knowledge.get(c).feat() == DNGN_TRANSPORTER
         // We have to actually take the transporter to go from c to dc.
         && !adjacent(c, dc))
     {
@@ -1596,7 +1599,7 @@ bool travel_pathfind::path_flood(const coord_def &c, const coord_def &dc)
 
         if (features && !ignore_hostile)
         {
-            dungeon_feature_type feature = env.map_knowledge(dc).feat();
+            dungeon_feature_type feature = env.map_knowledge.get(dc).feat();
 
             if (dc != start
                 && (feature != DNGN_FLOOR
@@ -1765,8 +1768,8 @@ void find_travel_pos(const coord_def& youpos,
         coord_def unseen = coord_def();
         for (adjacent_iterator ai(dest); ai; ++ai)
             if (!you.see_cell(*ai)
-                && (!env.map_knowledge(*ai).seen()
-                    || !feat_is_wall(env.map_knowledge(*ai).feat())))
+                && (!env.map_knowledge.get(*ai).seen()
+                    || !feat_is_wall(env.map_knowledge.get(*ai).feat())))
             {
                 unseen = *ai;
                 break;
@@ -1786,7 +1789,7 @@ void find_travel_pos(const coord_def& youpos,
             // previously unseen monster but the same would happen by manual
             // movement, so I don't think we need to worry about this. (jpeg)
             if (!_is_travelsafe_square(new_dest)
-                || !feat_is_traversable_now(env.map_knowledge(new_dest).feat()))
+                || !feat_is_traversable_now(env.map_knowledge.get(new_dest).feat()))
             {
                 new_dest = dest;
             }
@@ -3026,7 +3029,7 @@ static bool _find_transtravel_square(const level_pos &target, bool verbose)
     // behavior is that it will go to the level and then fail.
     const bool maybe_traversable = (target.id != current
                                     || (in_bounds(target.pos)
-                                        && feat_is_traversable_now(env.map_knowledge(target.pos).feat())));
+                                        && feat_is_traversable_now(env.map_knowledge.get(target.pos).feat())));
 
     if (maybe_traversable)
     {
@@ -3148,7 +3151,7 @@ void start_explore(bool grab_items)
     you.running = (grab_items ? RMODE_EXPLORE_GREEDY : RMODE_EXPLORE);
 
     for (rectangle_iterator ri(0); ri; ++ri)
-        if (env.map_knowledge(*ri).seen())
+        if (env.map_knowledge.get(*ri).seen())
             env.map_seen.set(*ri);
 
     you.running.pos.reset();
@@ -3643,7 +3646,7 @@ void LevelInfo::correct_stair_list(const vector<coord_def> &s)
             {
                 si.destination = travel_hell_entry;
             }
-            if (!env.map_knowledge(pos).seen())
+            if (!env.map_knowledge.get(pos).seen())
                 si.type = stair_info::MAPPED;
 
             // We don't know where on the next level these stairs go to, but
@@ -3652,7 +3655,7 @@ void LevelInfo::correct_stair_list(const vector<coord_def> &s)
             stairs.push_back(si);
         }
         else
-            stairs[found].type = env.map_knowledge(pos).seen() ? stair_info::PHYSICAL : stair_info::MAPPED;
+            stairs[found].type = env.map_knowledge.get(pos).seen() ? stair_info::PHYSICAL : stair_info::MAPPED;
     }
 
     resize_stair_distances();
@@ -3692,7 +3695,7 @@ void LevelInfo::correct_transporter_list(const vector<coord_def> &t)
         }
 
         transporter_info::transporter_type type =
-            env.map_knowledge(pos).seen() ? transporter_info::PHYSICAL
+            env.map_knowledge.get(pos).seen() ? transporter_info::PHYSICAL
                                           : transporter_info::MAPPED;
         if (found == -1)
             transporters.push_back(transporter_info(pos, coord_def(), type));
@@ -3731,8 +3734,8 @@ void LevelInfo::get_transporters(vector<coord_def> &tr)
         const dungeon_feature_type feat = grd(*ri);
 
         if (feat == DNGN_TRANSPORTER
-            && (*ri == you.pos() || env.map_knowledge(*ri).known())
-            && env.map_knowledge(*ri).seen())
+            && (*ri == you.pos() || env.map_knowledge.get(*ri).known())
+            && env.map_knowledge.get(*ri).seen())
         {
             tr.push_back(*ri);
         }
@@ -3745,9 +3748,9 @@ void LevelInfo::get_stairs(vector<coord_def> &st)
     {
         const dungeon_feature_type feat = grd(*ri);
 
-        if ((*ri == you.pos() || env.map_knowledge(*ri).known())
+        if ((*ri == you.pos() || env.map_knowledge.get(*ri).known())
             && feat_is_travelable_stair(feat)
-            && (env.map_knowledge(*ri).seen() || !_is_branch_stair(*ri)))
+            && (env.map_knowledge.get(*ri).seen() || !_is_branch_stair(*ri)))
         {
             st.push_back(*ri);
         }
@@ -3871,7 +3874,7 @@ void LevelInfo::fixup()
 
 void TravelCache::update_stone_stair(const coord_def &c)
 {
-    if (!env.map_knowledge(c).seen())
+    if (!env.map_knowledge.get(c).seen())
         return;
     LevelInfo *li = find_level_info(level_id::current());
     if (!li)
@@ -3918,7 +3921,7 @@ void TravelCache::update_transporter(const coord_def &c)
     const dungeon_feature_type feat = grd(c);
     ASSERT(feat == DNGN_TRANSPORTER);
 
-    if (!env.map_knowledge(c).seen())
+    if (!env.map_knowledge.get(c).seen())
         return;
 
     LevelInfo *li = find_level_info(level_id::current());
@@ -4338,7 +4341,7 @@ void runrest::set_run_check(int index, int dir)
     run_check[index].delta = Compass[dir];
 
     const coord_def p = you.pos() + Compass[dir];
-    run_check[index].grid = _base_feat_type(env.map_knowledge(p).feat());
+    run_check[index].grid = _base_feat_type(env.map_knowledge.get(p).feat());
 }
 
 bool runrest::check_stop_running()
@@ -4356,7 +4359,7 @@ bool runrest::check_stop_running()
 bool runrest::run_should_stop() const
 {
     const coord_def targ = you.pos() + pos;
-    const map_cell& tcell = env.map_knowledge(targ);
+    const map_cell& tcell = env.map_knowledge.get(targ);
 
     // XXX: probably this should ignore cosmetic clouds (non-opaque)
     if (tcell.cloud() != CLOUD_NONE
@@ -4385,7 +4388,7 @@ bool runrest::run_should_stop() const
     {
         const coord_def p = you.pos() + run_check[i].delta;
         const dungeon_feature_type feat =
-            _base_feat_type(env.map_knowledge(p).feat());
+            _base_feat_type(env.map_knowledge.get(p).feat());
 
         if (run_check[i].grid != feat)
             return true;
@@ -4410,7 +4413,7 @@ bool runrest::diag_run_passes_door() const
     for (int dir : diag_dirs)
     {
         const coord_def p = you.pos() + Compass[dir];
-        const auto feat = env.map_knowledge(p).feat();
+        const auto feat = env.map_knowledge.get(p).feat();
         if (feat_is_door(feat))
             return true;
     }
@@ -4580,7 +4583,7 @@ void explore_discoveries::found_feature(const coord_def &pos,
                 // If any neighbours have been seen (and thus announced)
                 // before, skip. For parts seen for the first time this turn,
                 // announce only the upper leftmost cell.
-                if (feat_is_runed(env.map_knowledge(*ai).feat())
+                if (feat_is_runed(env.map_knowledge.get(*ai).feat())
                     && (env.map_seen(*ai) || *ai < pos))
                 {
                     return;
@@ -4604,7 +4607,7 @@ void explore_discoveries::found_feature(const coord_def &pos,
                 // If any neighbours have been seen (and thus announced) before,
                 // skip. For parts seen for the first time this turn, announce
                 // only the upper leftmost cell.
-                if (env.map_knowledge(*ai).feat() == DNGN_TRANSPORTER
+                if (env.map_knowledge.get(*ai).feat() == DNGN_TRANSPORTER
                     && (env.map_seen(*ai) || *ai < pos))
                 {
                     return;
@@ -4936,7 +4939,7 @@ bool check_for_interesting_features()
         const coord_def p(*ri);
 
         // Find just noticed squares.
-        if (env.map_knowledge(p).flags & MAP_SEEN_FLAG
+        if (env.map_knowledge.get(p).flags & MAP_SEEN_FLAG
             && !env.map_seen(p))
         {
             // Update the shadow map
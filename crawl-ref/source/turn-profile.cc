@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @brief Turn loop instrumentation: wall time per subsystem, per-turn cost
+ *        histograms and event counters.
+ *
+ * The timers are cheap enough (two clock reads per timed call) to stay
+ * compiled in, so that reports of slow games on a server can come with the
+ * numbers of the game that was actually slow. Per-turn times are folded
+ * into totals and a log2 histogram at the end of every world_reacts().
+**/
+
+#include "AppHdr.h"
+
+#include "turn-profile.h"
+
+#include "chardump.h"
+#include "player.h"
+#include "stringutil.h"
+#include "syscalls.h"
+
+// Buckets of the per-turn histograms: bucket 0 is under 1us, bucket n covers
+// [2^(n-1), 2^n) microseconds, and the last one everything above.
+#define PROF_BUCKETS 24
+
+namespace turn_profile
+{
+    int64_t turn_ns[NUM_PROF_SECTIONS];
+    int active[NUM_PROF_SECTIONS];
+    int64_t counters[NUM_PROF_COUNTERS];
+}
+
+using namespace turn_profile;
+
+static int turns = 0;
+static int64_t total_ns[NUM_PROF_SECTIONS];
+static int64_t max_ns[NUM_PROF_SECTIONS];
+static int histogram[NUM_PROF_SECTIONS][PROF_BUCKETS];
+
+static const char *section_names[] =
+{
+    "world_reacts", "handle_monsters", "handle_monster_move",
+    "manage_clouds", "apply_noises", "los", "update_monsters_in_view",
+    "viewwindow", "webtiles",
+};
+COMPILE_CHECK(ARRAYSZ(section_names) == NUM_PROF_SECTIONS);
+
+static const char *counter_names[] =
+{
+    "monster moves", "tracers fired", "monster pathfinds",
+    "travel pathfinds", "LOS calculations", "webtiles bytes sent",
+};
+COMPILE_CHECK(ARRAYSZ(counter_names) == NUM_PROF_COUNTERS);
+
+static int _bucket(int64_t ns)
+{
+    int64_t us = ns / 1000;
+    int b = 0;
+    while (us && b < PROF_BUCKETS - 1)
+    {
+        us >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+/// Close the current turn: fold its section times into the statistics.
+void prof_end_turn()
+{
+    ++turns;
+    for (int i = 0; i < NUM_PROF_SECTIONS; ++i)
+    {
+        const int64_t ns = turn_ns[i];
+        total_ns[i] += ns;
+        max_ns[i] = max(max_ns[i], ns);
+        ++histogram[i][_bucket(ns)];
+        turn_ns[i] = 0;
+    }
+}
+
+void prof_reset()
+{
+    turns = 0;
+    for (int i = 0; i < NUM_PROF_SECTIONS; ++i)
+    {
+        turn_ns[i] = total_ns[i] = max_ns[i] = 0;
+        for (int b = 0; b < PROF_BUCKETS; ++b)
+            histogram[i][b] = 0;
+    }
+    for (int i = 0; i < NUM_PROF_COUNTERS; ++i)
+        counters[i] = 0;
+}
+
+int prof_turns()
+{
+    return turns;
+}
+
+int64_t prof_counter_total(prof_counter_type counter)
+{
+    return counters[counter];
+}
+
+// The upper bound of the histogram bucket containing the given quantile.
+static string _quantile(int section, double q)
+{
+    const int wanted = max(1, (int) ceil(turns * q));
+    int seen = 0;
+    for (int b = 0; b < PROF_BUCKETS; ++b)
+    {
+        seen += histogram[section][b];
+        if (seen >= wanted)
+        {
+            return b == PROF_BUCKETS - 1 ? ">" + to_string(1 << (b - 1))
+                                         : "<" + to_string(1 << b);
+        }
+    }
+    return "-";
+}
+
+static string _format_ms(int64_t ns)
+{
+    return make_stringf("%.3f", ns / 1e6);
+}
+
+/// A plain text table of the statistics gathered so far.
+string prof_report()
+{
+    string out = make_stringf("Turn profile over %d turns "
+                              "(times in ms, quantiles in us)\n\n", turns);
+    if (!turns)
+        return out;
+
+    out += make_stringf("%-24s %12s %10s %10s %8s %8s %8s\n",
+                        "section", "total", "mean", "max",
+                        "p50", "p90", "p99");
+    for (int i = 0; i < NUM_PROF_SECTIONS; ++i)
+    {
+        out += make_stringf("%-24s %12s %10s %10s %8s %8s %8s\n",
+                            section_names[i],
+                            _format_ms(total_ns[i]).c_str(),
+                            _format_ms(total_ns[i] / turns).c_str(),
+                            _format_ms(max_ns[i]).c_str(),
+                            _quantile(i, 0.5).c_str(),
+                            _quantile(i, 0.9).c_str(),
+                            _quantile(i, 0.99).c_str());
+    }
+
+    out += "\n";
+    for (int i = 0; i < NUM_PROF_COUNTERS; ++i)
+    {
+        out += make_stringf("%-24s %12" PRId64 " %10.2f/turn\n",
+                            counter_names[i], counters[i],
+                            (double) counters[i] / turns);
+    }
+
+    out += "\nworld_reacts histogram (us: turns)\n";
+    for (int b = 0; b < PROF_BUCKETS; ++b)
+    {
+        const int n = histogram[PROF_WORLD_REACTS][b];
+        if (n)
+            out += make_stringf("  <%-9d %d\n", 1 << b, n);
+    }
+    return out;
+}
+
+/// Write the report next to the character dumps, if anything was measured.
+void prof_write_dump()
+{
+    if (!turns)
+        return;
+
+    const string name = you.your_name.empty()
+                        ? string("turnprof.txt")
+                        : "turnprof-" + strip_filename_unsafe_chars(
+                              you.your_name) + ".txt";
+    const string file = morgue_directory() + name;
+    FILE *handle = fopen_u(file.c_str(), "w");
+    if (!handle)
+        return;
+    fprintf(handle, "%s", prof_report().c_str());
+    fclose(handle);
+}
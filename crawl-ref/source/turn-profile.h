@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief Turn loop instrumentation: wall time per subsystem, per-turn cost
+ *        histograms and event counters.
+**/
+
+#pragma once
+
+#include <chrono>
+
+enum prof_section_type
+{
+    PROF_WORLD_REACTS,
+    PROF_HANDLE_MONSTERS,
+    PROF_MONSTER_MOVE,
+    PROF_CLOUDS,
+    PROF_NOISES,
+    PROF_LOS,
+    PROF_MONSTERS_IN_VIEW,
+    PROF_VIEWWINDOW,
+    PROF_WEBTILES,
+    NUM_PROF_SECTIONS
+};
+
+enum prof_counter_type
+{
+    PROF_MONSTER_MOVES,
+    PROF_TRACERS,
+    PROF_MONSTER_PATHFINDS,
+    PROF_TRAVEL_PATHFINDS,
+    PROF_LOS_CALCS,
+    PROF_WEBTILES_BYTES,
+    NUM_PROF_COUNTERS
+};
+
+typedef chrono::steady_clock prof_clock;
+
+namespace turn_profile
+{
+    extern int64_t turn_ns[NUM_PROF_SECTIONS];
+    extern int active[NUM_PROF_SECTIONS];
+    extern int64_t counters[NUM_PROF_COUNTERS];
+}
+
+// Adds the wall time spent in its scope to a section. Time spent in
+// sections nested inside it is included; re-entering the same section
+// (e.g. handle_monster_move for a monster acting during another's move) is
+// only counted once.
+class prof_timer
+{
+public:
+    explicit prof_timer(prof_section_type s) : section(s)
+    {
+        if (!turn_profile::active[section]++)
+            start = prof_clock::now();
+    }
+
+    ~prof_timer()
+    {
+        if (!--turn_profile::active[section])
+        {
+            turn_profile::turn_ns[section] +=
+                chrono::duration_cast<chrono::nanoseconds>(
+                    prof_clock::now() - start).count();
+        }
+    }
+
+    prof_timer(const prof_timer &) = delete;
+    prof_timer &operator=(const prof_timer &) = delete;
+
+private:
+    prof_section_type section;
+    prof_clock::time_point start;
+};
+
+static inline void prof_count(prof_counter_type counter, int64_t n = 1)
+{
+    turn_profile::counters[counter] += n;
+}
+
+void prof_end_turn();
+void prof_reset();
+int prof_turns();
+int64_t prof_counter_total(prof_counter_type counter);
+string prof_report();
+void prof_write_dump();
@@ -72,6 +72,7 @@
 #include "tiles-build-specific.h"
 #include "traps.h"
 #include "travel.h"
+#include "turn-profile.h"
 #include "unicode.h"
 #include "unwind.h"
 #include "viewchar.h"
@@ -99,6 +100,8 @@ bool handle_seen_interrupt(monster* mons, vector<string>* msgs_buf)
     else
         aid.context = SC_NEWLY_SEEN;
 
+    // Whatever was found out before it came into view is out of date.
+    invalidate_threat_set();
     if (!mons_is_safe(mons))
         return interrupt_activity(AI_SEE_MONSTER, aid, msgs_buf);
 
@@ -298,7 +301,7 @@ static string _monster_headsup(const vector<monster*> &monsters,
     string warning_msg = "";
     for (const monster* mon : monsters)
     {
-        monster_info mi(mon);
+        const monster_info &mi = get_cached_monster_info(mon);
         const bool zin_ided = mon->props.exists("zin_id");
         const bool has_interesting_equipment
             = _is_mon_equipment_worth_listing(mi);
@@ -501,6 +504,8 @@ static void _maybe_gozag_incite(vector<monster*> monsters)
 
 void update_monsters_in_view()
 {
+    prof_timer timer(PROF_MONSTERS_IN_VIEW);
+
     int num_hostile = 0;
     vector<string> msgs;
     vector<monster*> monsters;
@@ -1028,14 +1033,14 @@ void view_update_at(const coord_def &pos)
     show_update_at(pos);
 
 #ifndef USE_TILE_LOCAL
-    if (!env.map_knowledge(pos).visible())
+    if (!env.map_knowledge.get(pos).visible())
         return;
     cglyph_t g = get_cell_glyph(pos);
 
     int flash_colour = you.flash_colour == BLACK
         ? viewmap_flash_colour()
         : you.flash_colour;
-    monster_type mons = env.map_knowledge(pos).monster();
+    monster_type mons = env.map_knowledge.get(pos).monster();
     int cell_colour =
         flash_colour &&
         (mons == MONS_NO_MONSTER || mons_class_is_firewood(mons))
@@ -1190,7 +1195,7 @@ static update_flags player_view_update_at(const coord_def &gc)
     if (crawl_state.game_is_hints())
         hints_observe_cell(gc);
 
-    if (env.map_knowledge(gc).changed() || !env.map_knowledge(gc).seen())
+    if (env.map_knowledge.get(gc).changed() || !env.map_knowledge.get(gc).seen())
         ret |= update_flag::affect_excludes;
 
     set_terrain_visible(gc);
@@ -1234,7 +1239,7 @@ static void player_view_update()
     vector<coord_def> update_excludes;
     bool need_update = false;
 
-    for (radius_iterator ri(you.pos(), you.xray_vision ? LOS_NONE : LOS_DEFAULT); ri; ++ri)
+    for (visible_radius_iterator ri(you.pos(), you.xray_vision ? LOS_NONE : LOS_DEFAULT); ri; ++ri)
     {
         update_flags flags = player_view_update_at(*ri);
         if (flags & update_flag::affect_excludes)
@@ -1530,6 +1535,8 @@ static bool _view_is_updating = false;
  */
 void viewwindow(bool show_updates, bool tiles_only, animation *a)
 {
+    prof_timer timer(PROF_VIEWWINDOW);
+
     if (_view_is_updating)
     {
         // recursive calls to this function can lead to memory corruption or
@@ -1590,7 +1597,10 @@ void viewwindow(bool show_updates, bool tiles_only, animation *a)
         bool run_dont_draw = you.running && Options.travel_delay < 0
                     && (!you.running.is_explore() || Options.explore_delay < 0);
         if (you.running && you.running.is_rest())
-            run_dont_draw = Options.rest_delay == -1;
+        {
+            run_dont_draw = Options.rest_delay == -1
+                            || rest_is_fast_forwarding();
+        }
 
         if (run_dont_draw || you.asleep())
         {
@@ -1602,6 +1612,9 @@ void viewwindow(bool show_updates, bool tiles_only, animation *a)
 
         cursor_control cs(false);
 
+        // Whether a turn is drawn must not change the game's random numbers.
+        rng_generator rng(RNG_UI);
+
         int flash_colour = you.flash_colour;
         if (flash_colour == BLACK)
             flash_colour = viewmap_flash_colour();
@@ -1675,7 +1688,8 @@ void draw_cell(screen_cell_t *cell, const coord_def &gc,
         _draw_outside_los(cell, gc, ep); // in los bounds but not visible
 
 #ifdef USE_TILE
-    cell->tile.map_knowledge = map_bounds(gc) ? env.map_knowledge(gc) : map_cell();
+    cell->tile.map_knowledge = map_bounds(gc) ? env.map_knowledge.get(gc)
+                                              : map_cell();
 #endif
 
     cell->flash_colour = BLACK;
@@ -1691,7 +1705,7 @@ void draw_cell(screen_cell_t *cell, const coord_def &gc,
                                && allow_mon_recolour
                                && map_bounds(gc)
                                && you.on_current_level
-                               && (env.map_knowledge(gc).flags & MAP_WITHHELD)
+                               && (env.map_knowledge.get(gc).flags & MAP_WITHHELD)
                                && !feat_is_solid(grd(gc)));
 
     // Alter colour if flashing the characters vision.
@@ -1759,7 +1773,7 @@ void draw_cell(screen_cell_t *cell, const coord_def &gc,
         && map_bounds(gc)
         && (_layers == LAYERS_NONE
             || gc != you.pos()
-               && (env.map_knowledge(gc).monster() == MONS_NO_MONSTER
+               && (env.map_knowledge.get(gc).monster() == MONS_NO_MONSTER
                    || !you.see_cell(gc)))
         && travel_colour_override(gc))
     {
@@ -89,7 +89,7 @@ bool travel_colour_override(const coord_def& p)
         return true;
 #endif
 
-    const map_cell& cell = env.map_knowledge(p);
+    const map_cell& cell = env.map_knowledge.get(p);
     show_class cls = get_cell_show_class(cell);
     if (cls == SH_FEATURE)
     {
@@ -134,10 +134,10 @@ static bool _is_player_defined_feature(char32_t feature)
 // 5. Anything else will look for the exact same character in the level map.
 bool is_feature(char32_t feature, const coord_def& where)
 {
-    if (!env.map_knowledge(where).known() && !you.see_cell(where) && !_is_player_defined_feature(feature))
+    if (!env.map_knowledge.get(where).known() && !you.see_cell(where) && !_is_player_defined_feature(feature))
         return false;
 
-    dungeon_feature_type grid = env.map_knowledge(where).feat();
+    dungeon_feature_type grid = env.map_knowledge.get(where).feat();
 
     switch (feature)
     {
@@ -175,7 +175,7 @@ bool is_feature(char32_t feature, const coord_def& where)
 
 static bool _is_feature_fudged(char32_t glyph, const coord_def& where)
 {
-    if (!env.map_knowledge(where).known() && !_is_player_defined_feature(glyph))
+    if (!env.map_knowledge.get(where).known() && !_is_player_defined_feature(glyph))
         return false;
 
     if (is_feature(glyph, where))
@@ -427,7 +427,7 @@ class feature_list
 
     group get_group(const coord_def& gc)
     {
-        dungeon_feature_type feat = env.map_knowledge(gc).feat();
+        dungeon_feature_type feat = env.map_knowledge.get(gc).feat();
 
         if (feat_is_staircase(feat) || feat_is_escape_hatch(feat))
             return feat_dir(feat);
@@ -443,7 +443,7 @@ class feature_list
     void maybe_add(const coord_def& gc)
     {
 #ifndef USE_TILE_LOCAL
-        if (!env.map_knowledge(gc).known())
+        if (!env.map_knowledge.get(gc).known())
             return;
 
         group grp = get_group(gc);
@@ -551,7 +551,7 @@ static level_pos _stair_dest(const coord_def& p, command_type dir)
     if (!in_bounds(p))
         return level_pos();
 
-    if (feat_stair_direction(env.map_knowledge(p).feat()) != dir)
+    if (feat_stair_direction(env.map_knowledge.get(p).feat()) != dir)
         return level_pos();
 
     LevelInfo *linf = travel_cache.find_level_info(level_id::current());
@@ -568,10 +568,10 @@ static level_pos _stair_dest(const coord_def& p, command_type dir)
 static void _unforget_map()
 {
     ASSERT(env.map_forgotten);
-    MapKnowledge &old(*env.map_forgotten);
+    const MapKnowledge &old(*env.map_forgotten);
 
     for (rectangle_iterator ri(0); ri; ++ri)
-        if (!env.map_knowledge(*ri).seen() && old(*ri).seen())
+        if (!env.map_knowledge.get(*ri).seen() && old(*ri).seen())
         {
             // Don't overwrite known squares, nor magic-mapped with
             // magic-mapped data -- what was forgotten is less up to date.
@@ -1258,7 +1258,7 @@ bool show_map(level_pos &lpos,
                 break; // allow mouse clicks to move cursor without leaving map mode
 #endif
             case CMD_MAP_DESCRIBE:
-                if (map_bounds(lpos.pos) && env.map_knowledge(lpos.pos).known())
+                if (map_bounds(lpos.pos) && env.map_knowledge.get(lpos.pos).known())
                 {
                     full_describe_square(lpos.pos, false);
                     redraw_map = true;
@@ -1343,8 +1343,8 @@ static cglyph_t _get_feat_glyph(const coord_def& gc)
 {
     // XXX: it's unclear whether we want to display all features
     // or just those not obscured by remembered/detected stuff.
-    dungeon_feature_type feat = env.map_knowledge(gc).feat();
-    const bool terrain_seen = env.map_knowledge(gc).seen();
+    dungeon_feature_type feat = env.map_knowledge.get(gc).feat();
+    const bool terrain_seen = env.map_knowledge.get(gc).seen();
     const feature_def &fdef = get_feature_def(feat);
     cglyph_t g;
     g.ch  = terrain_seen ? fdef.symbol() : fdef.magic_symbol();
@@ -8,18 +8,24 @@
 #include "wiz-fsim.h"
 
 #include <cerrno>
+#include <chrono>
 
 #include "beam.h"
 #include "bitary.h"
 #include "coordit.h"
 #include "dbg-util.h"
 #include "directn.h"
+#include "dungeon.h"
 #include "env.h"
 #include "fight.h"
+#include "hash.h"
+#include "initfile.h"
 #include "item-prop.h"
 #include "items.h"
 #include "item-use.h"
 #include "jobs.h"
+#include "json.h"
+#include "json-wrapper.h"
 #include "libutil.h"
 #include "makeitem.h"
 #include "message.h"
@@ -29,6 +35,8 @@
 #include "mon-place.h"
 #include "monster.h"
 #include "mon-util.h"
+#include "newgame-def.h"
+#include "ng-setup.h"
 #include "options.h"
 #include "output.h"
 #include "player-equip.h"
@@ -38,10 +46,12 @@
 #include "species.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "throw.h"
 #include "unwind.h"
 #include "version.h"
 #include "wiz-you.h"
+#include "worker-pool.h"
 
 #ifdef WIZARD
 
@@ -254,15 +264,17 @@ static bool _fsim_kit_equip(const string &kit, string &error)
         }
     }
 
-    redraw_screen();
+    // Batches run before the screen is set up.
+    if (crawl_state.io_inited)
+        redraw_screen();
     return true;
 }
 
 // fight simulator internals
-static monster* _init_fsim()
+static monster* _init_fsim(const string &mons_name)
 {
     monster * mon = nullptr;
-    monster_type mtype = get_monster_by_name(Options.fsim_mons, true);
+    monster_type mtype = get_monster_by_name(mons_name, true);
 
     if (mtype == MONS_PROGRAM_BUG && monster_nearby())
     {
@@ -333,7 +345,8 @@ static monster* _init_fsim()
     mon->hit_points = mon->max_hit_points = MAX_MONSTER_HP;
     mon->behaviour = BEH_SEEK;
 
-    redraw_screen();
+    if (crawl_state.io_inited)
+        redraw_screen();
 
     return mon;
 }
@@ -477,7 +490,7 @@ void fight_damage_stats::calc_output_stats()
 
 fight_data wizard_quick_fsim_raw(bool defend)
 {
-    monster *mon = _init_fsim();
+    monster *mon = _init_fsim(Options.fsim_mons);
     ASSERT(mon);
 
     const int iter_limit = Options.fsim_rounds;
@@ -493,7 +506,7 @@ void wizard_quick_fsim()
     // we could declare this in the fight calls, but i'm worried that
     // the actual monsters that are made will be slightly different,
     // so it's safer to do it here.
-    monster *mon = _init_fsim();
+    monster *mon = _init_fsim(Options.fsim_mons);
     if (!mon)
         return;
 
@@ -557,20 +570,48 @@ static string _init_scale(skill_map &scale, bool &xl_mode)
     return ret;
 }
 
-static void _fsim_simple_scale(FILE * o, monster* mon, bool defense)
+// Work out what a simple scale trains; returns the name of its column.
+static string _fsim_scale(skill_map &scale, bool &xl_mode, bool defense)
 {
-    skill_map scale;
-    bool xl_mode = false;
-    string col_name;
+    if (!Options.fsim_scale.empty())
+        return _init_scale(scale, xl_mode);
+
+    skill_type sk = defense ? SK_ARMOUR : _equipped_skill();
+    scale[sk] = 1;
+    return skill_name(sk);
+}
 
-    if (Options.fsim_scale.empty())
+static void _fsim_scale_point(const skill_map &scale, bool xl_mode, int i)
+{
+    if (xl_mode)
+        set_xl(i, true);
+    else
     {
-        skill_type sk = defense ? SK_ARMOUR : _equipped_skill();
-        scale[sk] = 1;
-        col_name = skill_name(sk);
+        for (const auto &entry : scale)
+            set_skill_level(entry.first, i / entry.second);
+    }
+}
+
+static void _fsim_double_skills(bool defense, skill_type &skx,
+                                skill_type &sky)
+{
+    if (defense)
+    {
+        skx = SK_ARMOUR;
+        sky = SK_DODGING;
     }
     else
-        col_name = _init_scale(scale, xl_mode);
+    {
+        skx = SK_FIGHTING;
+        sky = _equipped_skill();
+    }
+}
+
+static void _fsim_simple_scale(FILE * o, monster* mon, bool defense)
+{
+    skill_map scale;
+    bool xl_mode = false;
+    const string col_name = _fsim_scale(scale, xl_mode, defense);
 
     const string text_title = make_stringf("%s\n   | %s", col_name.c_str(),
                                       fight_data::header(false).c_str());
@@ -587,14 +628,7 @@ static void _fsim_simple_scale(FILE * o, monster* mon, bool defense)
     for (int i = xl_mode ? 1 : 0; i <= 27; i++)
     {
         clear_messages();
-
-        if (xl_mode)
-            set_xl(i, true);
-        else
-        {
-            for (const auto &entry : scale)
-                set_skill_level(entry.first, i / entry.second);
-        }
+        _fsim_scale_point(scale, xl_mode, i);
 
         fight_data fdata = _get_fight_data(*mon, iter_limit, defense);
         results.emplace_back(i, fdata);
@@ -638,16 +672,7 @@ static void _fsim_simple_scale(FILE * o, monster* mon, bool defense)
 static void _fsim_double_scale(FILE * o, monster* mon, bool defense)
 {
     skill_type skx, sky;
-    if (defense)
-    {
-        skx = SK_ARMOUR;
-        sky = SK_DODGING;
-    }
-    else
-    {
-        skx = SK_FIGHTING;
-        sky = _equipped_skill();
-    }
+    _fsim_double_skills(defense, skx, sky);
 
     fprintf(o, "%s(x) vs %s(y)\n", skill_name(skx), skill_name(sky));
     fprintf(o, Options.fsim_csv ? "\t" : "  ");
@@ -686,7 +711,7 @@ static void _fsim_double_scale(FILE * o, monster* mon, bool defense)
 
 void wizard_fight_sim(bool double_scale)
 {
-    monster * mon = _init_fsim();
+    monster * mon = _init_fsim(Options.fsim_mons);
     if (!mon)
         return;
 
@@ -785,4 +810,360 @@ void wizard_fight_sim(bool double_scale)
     mpr("Done.");
 }
 
+// Fight sim batches: every combination of kit, monster, mode and point on
+// the scales, each run in a worker process from the same starting position.
+
+// One point of a batch.
+struct fsim_cell
+{
+    string kit;         // empty to keep the starting equipment
+    string mons;
+    bool defend;
+    bool double_scale;
+    int x;              // skill level or XL
+    int y;              // second skill level on the double scale, else -1
+
+    string key() const
+    {
+        return make_stringf("%s|%s|%d|%d|%d|%d", kit.c_str(), mons.c_str(),
+                            defend, double_scale, x, y);
+    }
+};
+
+// The outcome of one cell, passed back from the worker that ran it.
+struct fsim_cell_result
+{
+    string x_name;      // what the scales measure, which depends on the kit
+    string y_name;
+    fight_data fdata;
+    string error;
+
+    string serialise() const
+    {
+        const fight_damage_stats &p = fdata.player;
+        const fight_damage_stats &m = fdata.monster;
+        string data = make_stringf("%d %u %d %d %d %d %u %d %d %d\n",
+                                   p.hits, p.cumulative_damage, p.max_dam,
+                                   p.time_taken, p.iterations, m.hits,
+                                   m.cumulative_damage, m.max_dam,
+                                   m.time_taken, m.iterations);
+        data += x_name + "\n" + y_name + "\n";
+        data += replace_all(error, "\n", " ");
+        return data;
+    }
+
+    bool deserialise(const string &data)
+    {
+        fight_damage_stats &p = fdata.player;
+        fight_damage_stats &m = fdata.monster;
+        const vector<string> lines = split_string("\n", data, false, true,
+                                                  3);
+        if (lines.size() < 4
+            || sscanf(lines[0].c_str(), "%d %u %d %d %d %d %u %d %d %d",
+                      &p.hits, &p.cumulative_damage, &p.max_dam,
+                      &p.time_taken, &p.iterations, &m.hits,
+                      &m.cumulative_damage, &m.max_dam, &m.time_taken,
+                      &m.iterations) != 10)
+        {
+            return false;
+        }
+        x_name = lines[1];
+        y_name = lines[2];
+        error = lines[3];
+        if (error.empty())
+        {
+            p.calc_output_stats();
+            m.calc_output_stats();
+        }
+        return true;
+    }
+};
+
+static vector<fsim_cell> fsim_cells;
+static uint64_t fsim_seed = 0;
+
+/// Run cell number `index`; called in a worker process.
+static string _fsim_batch_job(int index)
+{
+    const fsim_cell &cell = fsim_cells[index];
+    // Seed from the cell rather than from the worker or the cell's index,
+    // so that a cell's numbers don't depend on the rest of the matrix.
+    const string key = cell.key();
+    seed_rng(fsim_seed + hash32(key.data(), key.size()));
+
+    fsim_cell_result result;
+    no_messages mx;
+
+    monster *mon = _init_fsim(cell.mons);
+    if (!mon)
+    {
+        result.error = "could not place the monster";
+        return result.serialise();
+    }
+
+    string error;
+    if (!cell.kit.empty() && !_fsim_kit_equip(cell.kit, error))
+    {
+        result.error = error.empty() ? "could not equip the kit" : error;
+        return result.serialise();
+    }
+
+    if (cell.double_scale)
+    {
+        skill_type skx, sky;
+        _fsim_double_skills(cell.defend, skx, sky);
+        set_skill_level(skx, cell.x);
+        set_skill_level(sky, cell.y);
+        result.x_name = skill_name(skx);
+        result.y_name = skill_name(sky);
+    }
+    else
+    {
+        skill_map scale;
+        bool xl_mode = false;
+        result.x_name = _fsim_scale(scale, xl_mode, cell.defend);
+        _fsim_scale_point(scale, xl_mode, cell.x);
+    }
+
+    result.fdata = _get_fight_data(*mon, Options.fsim_rounds, cell.defend);
+    return result.serialise();
+}
+
+static void _fsim_batch_matrix()
+{
+    const bool defend = Options.fsim_mode.find("defen") != string::npos;
+    const bool attack = Options.fsim_mode.find("attack") != string::npos
+                        || Options.fsim_mode.find("offen") != string::npos;
+    const bool dbl = Options.fsim_mode.find("double") != string::npos;
+    const bool simple = Options.fsim_mode.find("simple") != string::npos;
+
+    vector<bool> modes;
+    if (attack || !defend)
+        modes.push_back(false);
+    if (defend || !attack)
+        modes.push_back(true);
+
+    vector<bool> scales;
+    if (simple || !dbl)
+        scales.push_back(false);
+    if (dbl)
+        scales.push_back(true);
+
+    const bool xl_mode = find(Options.fsim_scale.begin(),
+                              Options.fsim_scale.end(), "xl")
+                         != Options.fsim_scale.end();
+
+    vector<string> kits = Options.fsim_kit;
+    if (kits.empty())
+        kits.emplace_back();
+
+    for (const string &kit : kits)
+        for (const string &mons : split_string(",", Options.fsim_mons))
+            for (bool defense : modes)
+                for (bool double_scale : scales)
+                {
+                    fsim_cell cell = { kit, mons, defense, double_scale, 0,
+                                       -1 };
+                    if (!double_scale)
+                    {
+                        for (cell.x = xl_mode ? 1 : 0; cell.x <= 27; cell.x++)
+                            fsim_cells.push_back(cell);
+                        continue;
+                    }
+                    for (cell.y = 1; cell.y <= 27; cell.y += 2)
+                        for (cell.x = 1; cell.x <= 27; cell.x += 2)
+                            fsim_cells.push_back(cell);
+                }
+}
+
+// Start a character the way the fsim test does: on a fresh D:1, next to
+// some floor for the monster.
+static void _fsim_batch_setup(const string &combo)
+{
+    newgame_def ng;
+    ng.type = GAME_TYPE_NORMAL;
+    ng.species = get_species_by_abbrev(combo.substr(0, 2).c_str());
+    ng.job = get_job_by_abbrev(combo.substr(2, 2).c_str());
+    if (ng.species == SP_UNKNOWN || ng.job == JOB_UNKNOWN)
+        end(1, false, "Unknown species/background combo: %s\n", combo.c_str());
+    // Kits bring their own weapons.
+    ng.weapon = WPN_UNARMED;
+
+    setup_game(ng);
+    you.save->unlink();
+    you.save = nullptr;
+    you.wizard = true;
+
+    no_messages mx;
+    dgn_flush_map_memory();
+    init_level_connectivity();
+    you.goto_place(level_id(BRANCH_DUNGEON, 1));
+    env.map_knowledge.init(map_cell());
+    los_changed();
+    builder();
+
+    env.grid(coord_def(2, 2)) = DNGN_FLOOR;
+    env.grid(coord_def(2, 3)) = DNGN_FLOOR;
+    you.moveto(coord_def(2, 2));
+}
+
+static void _fsim_stats_csv(FILE *o, const fight_damage_stats &st)
+{
+    fprintf(o, ",%d,%.2f,%d,%d,%.2f,%d,%.3f,%.2f", st.hits, st.av_hit_dam,
+            st.max_dam, st.accuracy, st.av_dam, st.av_time, st.av_speed,
+            st.av_eff_dam);
+}
+
+static JsonNode *_fsim_stats_json(const fight_damage_stats &st)
+{
+    JsonNode *node = json_mkobject();
+    json_append_member(node, "hits", json_mknumber(st.hits));
+    json_append_member(node, "av_hit_dam", json_mknumber(st.av_hit_dam));
+    json_append_member(node, "max_dam", json_mknumber(st.max_dam));
+    json_append_member(node, "accuracy", json_mknumber(st.accuracy));
+    json_append_member(node, "av_dam", json_mknumber(st.av_dam));
+    json_append_member(node, "av_time", json_mknumber(st.av_time));
+    json_append_member(node, "av_speed", json_mknumber(st.av_speed));
+    json_append_member(node, "av_eff_dam", json_mknumber(st.av_eff_dam));
+    return node;
+}
+
+static void _write_fsim_batch_report(const vector<fsim_cell_result> &results,
+                                     const vector<bool> &ok, double seconds)
+{
+    const string filename = SysEnv.report_file.empty()
+                            ? "fsim-batch.json" : SysEnv.report_file;
+    FILE *report = fopen_u(filename.c_str(), "w");
+    if (!report)
+    {
+        printf("Can't write fight sim report to %s\n", filename.c_str());
+        return;
+    }
+
+    const bool csv = ends_with(lowercase_string(filename), ".csv");
+    JsonNode *cells = csv ? nullptr : json_mkarray();
+    if (csv)
+    {
+        fprintf(report, "kit,monster,mode,x_scale,x,y_scale,y");
+        for (const char *who : { "player", "monster" })
+        {
+            fprintf(report, ",%s_hits,%s_av_hit_dam,%s_max_dam,%s_accuracy,"
+                            "%s_av_dam,%s_av_time,%s_av_speed,%s_av_eff_dam",
+                    who, who, who, who, who, who, who, who);
+        }
+        fprintf(report, ",error\n");
+    }
+
+    int failed = 0;
+    for (unsigned int i = 0; i < results.size(); ++i)
+    {
+        const fsim_cell &cell = fsim_cells[i];
+        const fsim_cell_result &res = results[i];
+        const string error = ok[i] ? res.error
+                                   : "worker failed while running this cell";
+        if (!error.empty())
+            ++failed;
+
+        if (csv)
+        {
+            fprintf(report, "\"%s\",\"%s\",%s,%s,%d,%s,%d",
+                    replace_all(cell.kit, "\"", "\"\"").c_str(),
+                    replace_all(cell.mons, "\"", "\"\"").c_str(),
+                    cell.defend ? "defense" : "attack", res.x_name.c_str(),
+                    cell.x, res.y_name.c_str(), cell.y);
+            _fsim_stats_csv(report, res.fdata.player);
+            _fsim_stats_csv(report, res.fdata.monster);
+            fprintf(report, ",\"%s\"\n",
+                    replace_all(error, "\"", "\"\"").c_str());
+            continue;
+        }
+
+        JsonNode *entry = json_mkobject();
+        json_append_member(entry, "kit", json_mkstring(cell.kit.c_str()));
+        json_append_member(entry, "monster",
+                           json_mkstring(cell.mons.c_str()));
+        json_append_member(entry, "mode",
+                           json_mkstring(cell.defend ? "defense" : "attack"));
+        json_append_member(entry, "x_scale",
+                           json_mkstring(res.x_name.c_str()));
+        json_append_member(entry, "x", json_mknumber(cell.x));
+        if (cell.double_scale)
+        {
+            json_append_member(entry, "y_scale",
+                               json_mkstring(res.y_name.c_str()));
+            json_append_member(entry, "y", json_mknumber(cell.y));
+        }
+        if (!error.empty())
+            json_append_member(entry, "error", json_mkstring(error.c_str()));
+        else
+        {
+            json_append_member(entry, "player",
+                               _fsim_stats_json(res.fdata.player));
+            json_append_member(entry, "monster",
+                               _fsim_stats_json(res.fdata.monster));
+        }
+        json_append_element(cells, entry);
+    }
+
+    if (!csv)
+    {
+        JsonWrapper json(json_mkobject());
+        json_append_member(json.node, "version",
+                           json_mkstring(Version::Long));
+        json_append_member(json.node, "character",
+                           json_mkstring(SysEnv.fsim_combo.c_str()));
+        json_append_member(json.node, "seed",
+                           json_mkstring(to_string(fsim_seed).c_str()));
+        json_append_member(json.node, "rounds",
+                           json_mknumber(Options.fsim_rounds));
+        json_append_member(json.node, "seconds", json_mknumber(seconds));
+        json_append_member(json.node, "cells", cells);
+        fprintf(report, "%s\n", json.to_string().c_str());
+    }
+    fclose(report);
+
+    printf("Ran %u fight sim cell(s) in %.1fs, %d failed. Report: %s\n",
+           (unsigned int) results.size(), seconds, failed, filename.c_str());
+}
+
+/**
+ * Run the fight simulator headlessly for the character given by -fsim, over
+ * every combination of fsim_kit, the comma-separated monsters of fsim_mons,
+ * attack and/or defense and the simple and/or double scale (as chosen by
+ * fsim_mode), spread over -workers processes. Each point of each scale is
+ * one job, started from the same position with its own seed, so the merged
+ * report doesn't depend on the number of workers.
+ */
+void wizard_fsim_batch(const string &combo)
+{
+    _fsim_batch_setup(combo);
+
+    for (const string &mons : split_string(",", Options.fsim_mons))
+        if (get_monster_by_name(mons, true) == MONS_PROGRAM_BUG)
+            end(1, false, "Unknown monster for -fsim: %s\n", mons.c_str());
+    _fsim_batch_matrix();
+    if (fsim_cells.empty())
+        end(1, false, "No monsters to simulate; set fsim_mons.\n");
+
+    fsim_seed = you.game_seed;
+
+    printf("Running %u fight sim cell(s) of %d round(s) with %d worker(s).\n",
+           (unsigned int) fsim_cells.size(), Options.fsim_rounds,
+           worker_count());
+    fflush(stdout);
+
+    const auto start = chrono::steady_clock::now();
+    const vector<string> data = run_worker_jobs(fsim_cells.size(),
+                                                _fsim_batch_job);
+    const chrono::duration<double> elapsed =
+        chrono::steady_clock::now() - start;
+
+    vector<fsim_cell_result> results(data.size());
+    vector<bool> ok(data.size());
+    for (unsigned int i = 0; i < data.size(); ++i)
+        ok[i] = results[i].deserialise(data[i]);
+
+    _write_fsim_batch_report(results, ok, elapsed.count());
+}
+
 #endif
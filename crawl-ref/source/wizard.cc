@@ -126,7 +126,7 @@ static void _do_wizard_command(int wiz_command)
 
     case 'o': wizard_create_spec_object(); break;
     case 'O': debug_test_explore(); break;
-    // case CONTROL('O'): break;
+    case CONTROL('O'): debug_show_turn_profile(); break;
 
     case 'p': wizard_transform(); break;
     case 'P': debug_place_map(true); break;
@@ -495,6 +495,7 @@ int list_wizard_commands(bool do_redraw_screen)
                        "<w>Ctrl-F</w> double scale fsim\n"
                        "<w>Ctrl-I</w> item generation stats\n"
                        "<w>O</w>      measure exploration time\n"
+                       "<w>Ctrl-O</w> show turn loop profile\n"
                        "<w>Ctrl-T</w> dungeon (D)Lua interpreter\n"
                        "<w>Ctrl-U</w> client (C)Lua interpreter\n"
                        "<w>Ctrl-X</w> Xom effect stats\n"
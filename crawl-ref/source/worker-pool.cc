@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @brief Run independent batch jobs (arena rounds, simulations) in parallel
+ *        worker processes.
+ *
+ * Each job is identified by its index and returns its result serialised as
+ * a string. Jobs are dealt round-robin to forked workers, which send their
+ * results back to the parent over a pipe. The game state of the parent is
+ * never touched by a job, so callers can treat the jobs as pure functions
+ * of their index (typically seeding the RNG from it).
+**/
+
+#include "AppHdr.h"
+
+#include "worker-pool.h"
+
+#include <cerrno>
+
+#ifndef TARGET_OS_WINDOWS
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
+#include "initfile.h"
+
+/// The number of workers to use: -workers if given, else one per CPU.
+int worker_count()
+{
+    if (SysEnv.workers > 0)
+        return SysEnv.workers;
+#if !defined(TARGET_OS_WINDOWS) && defined(_SC_NPROCESSORS_ONLN)
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0)
+        return cpus;
+#endif
+    return 1;
+}
+
+#ifndef TARGET_OS_WINDOWS
+static bool _write_all(int fd, const void *buf, size_t len)
+{
+    const char *p = static_cast<const char *>(buf);
+    while (len > 0)
+    {
+        const ssize_t done = write(fd, p, len);
+        if (done < 0 && errno == EINTR)
+            continue;
+        if (done <= 0)
+            return false;
+        p += done;
+        len -= done;
+    }
+    return true;
+}
+
+static bool _read_all(int fd, void *buf, size_t len)
+{
+    char *p = static_cast<char *>(buf);
+    while (len > 0)
+    {
+        const ssize_t done = read(fd, p, len);
+        if (done < 0 && errno == EINTR)
+            continue;
+        if (done <= 0)
+            return false;
+        p += done;
+        len -= done;
+    }
+    return true;
+}
+
+// Body of a forked worker: run every workers'th job starting at `first`,
+// streaming (index, length, data) records down the pipe.
+NORETURN static void _worker_main(int fd, int first, int njobs, int workers,
+                                  const worker_job &job)
+{
+    for (int i = first; i < njobs; i += workers)
+    {
+        const string result = job(i);
+        const uint32_t header[2] = { (uint32_t) i, (uint32_t) result.size() };
+        if (!_write_all(fd, header, sizeof(header))
+            || !_write_all(fd, result.data(), result.size()))
+        {
+            _exit(1);
+        }
+    }
+    close(fd);
+    // Skip atexit handlers and stdio teardown: those belong to the parent.
+    _exit(0);
+}
+#endif
+
+/**
+ * Run job(0) .. job(njobs - 1) and collect their results.
+ *
+ * @param njobs   The number of jobs.
+ * @param job     The job to run; it is called with the job's index.
+ * @param workers How many processes to use; 0 means worker_count().
+ * @return The result of each job, by index. A job whose worker crashed
+ *         has an empty result.
+ */
+vector<string> run_worker_jobs(int njobs, const worker_job &job, int workers)
+{
+    vector<string> results(njobs);
+    vector<bool> done(njobs, false);
+
+    if (workers <= 0)
+        workers = worker_count();
+    workers = min(workers, njobs);
+
+#ifndef TARGET_OS_WINDOWS
+    if (workers > 1)
+    {
+        // Don't let the children inherit (and flush twice) buffered output.
+        fflush(stdout);
+        fflush(stderr);
+
+        vector<pid_t> pids;
+        vector<int> fds;
+        for (int w = 0; w < workers; ++w)
+        {
+            int fd[2];
+            if (pipe(fd) < 0)
+                break;
+
+            const pid_t pid = fork();
+            if (pid < 0)
+            {
+                close(fd[0]);
+                close(fd[1]);
+                break;
+            }
+            if (!pid)
+            {
+                close(fd[0]);
+                for (int other : fds)
+                    close(other);
+                _worker_main(fd[1], w, njobs, workers, job);
+            }
+            close(fd[1]);
+            pids.push_back(pid);
+            fds.push_back(fd[0]);
+        }
+
+        // Workers that failed to fork have their jobs run locally below.
+        const int forked = pids.size();
+        for (int w = 0; w < forked; ++w)
+        {
+            uint32_t header[2];
+            while (_read_all(fds[w], header, sizeof(header)))
+            {
+                const int i = header[0];
+                string result(header[1], '\0');
+                if (i < 0 || i >= njobs
+                    || !_read_all(fds[w], &result[0], result.size()))
+                {
+                    break;
+                }
+                results[i] = result;
+            }
+            close(fds[w]);
+            waitpid(pids[w], nullptr, 0);
+
+            for (int i = w; i < njobs; i += workers)
+                done[i] = true;
+        }
+    }
+#endif
+
+    for (int i = 0; i < njobs; ++i)
+        if (!done[i])
+            results[i] = job(i);
+
+    return results;
+}
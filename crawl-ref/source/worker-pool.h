@@ -0,0 +1,15 @@
+/**
+ * @file
+ * @brief Run independent batch jobs (arena rounds, simulations) in parallel
+ *        worker processes.
+**/
+
+#pragma once
+
+#include <functional>
+
+typedef function<string (int)> worker_job;
+
+int worker_count();
+vector<string> run_worker_jobs(int njobs, const worker_job &job,
+                               int workers = 0);